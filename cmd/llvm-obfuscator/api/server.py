@@ -1,13 +1,14 @@
 from __future__ import annotations
 
 import base64
+import json
 import logging
 import os
 from pathlib import Path
 from typing import Dict, Optional, Tuple
 
-from fastapi import BackgroundTasks, Depends, FastAPI, HTTPException, Request, WebSocket, WebSocketDisconnect
-from fastapi.responses import FileResponse, JSONResponse
+from fastapi import Depends, FastAPI, HTTPException, Request, WebSocket, WebSocketDisconnect
+from fastapi.responses import FileResponse, JSONResponse, Response
 from pydantic import BaseModel, Field
 
 from core import (
@@ -21,8 +22,11 @@ from core import (
 from core.comparer import CompareConfig, compare_binaries
 from core.config import AdvancedConfiguration, PassConfiguration, SymbolObfuscationConfiguration
 from core.exceptions import JobNotFoundError, ValidationError
+from core.job_executor import JobExecutor, QueueFullError
 from core.job_manager import JobManager
+from core.job_queue import JobQueue
 from core.progress import ProgressEvent, ProgressTracker
+from core.report_store import ReportStore
 from core.utils import create_logger, ensure_directory, normalize_flags_and_passes
 
 # Load flags database for the /api/flags endpoint. Prefer importing from the
@@ -52,7 +56,29 @@ progress_tracker = ProgressTracker()
 report_base = Path("reports").resolve()
 ensure_directory(report_base)
 reporter = ObfuscationReport(report_base)
-obfuscator = LLVMObfuscator(reporter=reporter)
+# Content-addressed archive of finished job artifacts: deduplicated,
+# compressed at rest, and indexed for O(1) job_id -> artifact lookup. Serving
+# falls back to it when the raw working directory has been cleaned up.
+report_store = ReportStore(report_base / ".store")
+obfuscator = LLVMObfuscator(reporter=reporter, progress_callback=progress_tracker.publish_sync)
+
+
+def _record_job_resources(job_id: str, metrics: Dict) -> None:
+    try:
+        job_manager.update_job(job_id, resources=metrics)
+    except JobNotFoundError:  # pragma: no cover - job evicted mid-run
+        logger.warning("Resource metrics for unknown job %s", job_id)
+
+
+# Bounded execution: OBFUSCATOR_WORKERS concurrent obfuscations, up to
+# OBFUSCATOR_QUEUE_DEPTH jobs waiting; beyond that /api/obfuscate answers 429.
+job_executor = JobExecutor(on_metrics=_record_job_resources)
+
+# Distributed mode: async jobs go to the shared broker instead of the local
+# pool, and external worker processes (`obfuscate worker`) execute them. The
+# queue database and report store must live on storage all nodes share.
+DISTRIBUTED_MODE = os.environ.get("OBFUSCATOR_DISTRIBUTED", "false").lower() == "true"
+job_queue = JobQueue() if DISTRIBUTED_MODE else None
 
 
 def _find_default_plugin() -> Tuple[Optional[str], bool]:
@@ -99,6 +125,16 @@ class PassesModel(BaseModel):
     substitution: bool = False
     bogus_control_flow: bool = False
     split: bool = False
+    linear_mba: bool = False
+    # Function-level targeting: exclude hot paths from every pass, or limit
+    # the passes to an explicit allow list.
+    skip_functions: list[str] = Field(default_factory=list)
+    only_functions: list[str] = Field(default_factory=list)
+    # Linear-MBA cost budget: rewrite depth cap, per-function instruction
+    # growth cap (percent), and reduced intensity inside nested loops.
+    mba_max_depth: Optional[int] = Field(None, ge=1, le=16)
+    mba_growth_cap_percent: Optional[int] = Field(None, ge=0, le=2000)
+    mba_loop_aware: bool = False
 
 
 class SymbolObfuscationModel(BaseModel):
@@ -110,18 +146,35 @@ class SymbolObfuscationModel(BaseModel):
 
 
 class ConfigModel(BaseModel):
-    level: int = Field(3, ge=1, le=5)
+    # Level 0 is adaptive: pass intensity per function is decided from a
+    # profile of profile_workload to meet profile_budget_percent.
+    level: int = Field(3, ge=0, le=5)
     passes: PassesModel = PassesModel()
     cycles: int = Field(1, ge=1, le=5)
     string_encryption: bool = False
+    string_encryption_mode: str = Field("heap", pattern="^(heap|arena|constexpr)$")
+    string_encryption_lazy: bool = False
+    string_encryption_simd: bool = False
+    string_encryption_packed: bool = False
+    string_encryption_dedup: bool = True
     fake_loops: int = Field(0, ge=0, le=50)
     symbol_obfuscation: SymbolObfuscationModel = SymbolObfuscationModel()
+    no_cache: bool = False
+    profile: bool = False
+    # Workload command for the adaptive level; "{binary}" expands to the
+    # instrumented binary path, otherwise the path is appended.
+    profile_workload: Optional[str] = None
+    profile_budget_percent: float = Field(2.0, ge=0.0, le=100.0)
 
 
 class ObfuscateRequest(BaseModel):
     source_code: str
     filename: str
     platform: Platform = Platform.LINUX
+    # Optional multi-platform fan-out: source transforms run once, then each
+    # platform is lowered concurrently; artifacts land in per-platform
+    # subdirectories served by /api/download/{job_id}/{platform}.
+    platforms: Optional[list[Platform]] = None
     config: ConfigModel = ConfigModel()
     report_formats: Optional[list[str]] = Field(default_factory=lambda: ["json", "markdown"])
     custom_flags: Optional[list[str]] = None
@@ -168,6 +221,32 @@ def _validate_source_size(source_b64: str) -> None:
         raise HTTPException(status_code=413, detail="Source too large")
 
 
+async def _stream_to_file(request: Request, destination: Path) -> int:
+    """Write the request body to disk as chunks arrive, enforcing the size cap.
+
+    Never holds more than one chunk in memory; on overflow the partial file
+    is removed before the 413 is raised. Returns the number of bytes written.
+    """
+    declared = request.headers.get("content-length")
+    if declared and declared.isdigit() and int(declared) > MAX_SOURCE_SIZE:
+        raise HTTPException(status_code=413, detail="Source too large")
+    total = 0
+    try:
+        with destination.open("wb") as sink:
+            async for chunk in request.stream():
+                total += len(chunk)
+                if total > MAX_SOURCE_SIZE:
+                    raise HTTPException(status_code=413, detail="Source too large")
+                sink.write(chunk)
+    except HTTPException:
+        destination.unlink(missing_ok=True)
+        raise
+    except Exception:
+        destination.unlink(missing_ok=True)
+        raise HTTPException(status_code=400, detail="Upload interrupted")
+    return total
+
+
 def _sanitize_filename(name: str) -> str:
     # Keep simple ASCII filename with word chars, dashes, underscores, dots
     import re
@@ -188,7 +267,11 @@ def _decode_source(source_b64: str, destination: Path) -> None:
         destination.write_bytes(decoded)
 
 
-def _build_config_from_request(payload: ObfuscateRequest, destination_dir: Path) -> ObfuscationConfig:
+def _config_data_from_request(payload: ObfuscateRequest, destination_dir: Path) -> Dict:
+    """Flatten the request into the ObfuscationConfig.from_dict shape.
+
+    Kept as a plain dict so the distributed path can ship it to a worker
+    verbatim; the local path feeds it straight to from_dict."""
     detected_flags: list[str] = payload.custom_flags or []
     sanitized_flags, detected_passes = normalize_flags_and_passes(detected_flags)
     passes = PassConfiguration(
@@ -196,6 +279,12 @@ def _build_config_from_request(payload: ObfuscateRequest, destination_dir: Path)
         substitution=payload.config.passes.substitution or detected_passes.get("substitution", False),
         bogus_control_flow=payload.config.passes.bogus_control_flow or detected_passes.get("boguscf", False),
         split=payload.config.passes.split or detected_passes.get("split", False),
+        linear_mba=payload.config.passes.linear_mba or detected_passes.get("linear-mba", False),
+        skip_functions=list(payload.config.passes.skip_functions),
+        only_functions=list(payload.config.passes.only_functions),
+        mba_max_depth=payload.config.passes.mba_max_depth,
+        mba_growth_cap_percent=payload.config.passes.mba_growth_cap_percent,
+        mba_loop_aware=payload.config.passes.mba_loop_aware,
     )
     symbol_obf = SymbolObfuscationConfiguration(
         enabled=payload.config.symbol_obfuscation.enabled,
@@ -218,8 +307,7 @@ def _build_config_from_request(payload: ObfuscateRequest, destination_dir: Path)
     if any_pass_requested and not chosen_plugin and DEFAULT_PASS_PLUGIN_EXISTS:
         chosen_plugin = DEFAULT_PASS_PLUGIN_PATH
 
-    output_config = ObfuscationConfig.from_dict(
-        {
+    return {
             "level": payload.config.level,
             "platform": payload.platform.value,
             "passes": {
@@ -227,10 +315,23 @@ def _build_config_from_request(payload: ObfuscateRequest, destination_dir: Path)
                 "substitution": passes.substitution,
                 "bogus_control_flow": passes.bogus_control_flow,
                 "split": passes.split,
+                "linear_mba": passes.linear_mba,
+                "skip_functions": passes.skip_functions,
+                "only_functions": passes.only_functions,
+                "mba_max_depth": passes.mba_max_depth,
+                "mba_growth_cap_percent": passes.mba_growth_cap_percent,
+                "mba_loop_aware": passes.mba_loop_aware,
             },
             "advanced": {
                 "cycles": advanced.cycles,
                 "string_encryption": advanced.string_encryption,
+                "string_encryption_config": {
+                    "mode": payload.config.string_encryption_mode,
+                    "lazy": payload.config.string_encryption_lazy,
+                    "simd": payload.config.string_encryption_simd,
+                    "packed_table": payload.config.string_encryption_packed,
+                    "deduplicate": payload.config.string_encryption_dedup,
+                },
                 "fake_loops": advanced.fake_loops,
                 "symbol_obfuscation": {
                     "enabled": symbol_obf.enabled,
@@ -246,23 +347,64 @@ def _build_config_from_request(payload: ObfuscateRequest, destination_dir: Path)
             },
             "compiler_flags": sanitized_flags,
             "custom_pass_plugin": chosen_plugin,
-        }
-    )
-    return output_config
+            "cache": not payload.config.no_cache,
+            "profile": payload.config.profile,
+            "profile_guided": {
+                "workload": payload.config.profile_workload,
+                "overhead_budget_percent": payload.config.profile_budget_percent,
+            },
+    }
+
+
+def _build_config_from_request(payload: ObfuscateRequest, destination_dir: Path) -> ObfuscationConfig:
+    return ObfuscationConfig.from_dict(_config_data_from_request(payload, destination_dir))
 
 
-def _run_obfuscation(job_id: str, source_path: Path, config: ObfuscationConfig) -> None:
+def _archive_job(job_id: str, working_dir: Path) -> None:
+    """Fold the finished job's artifacts into the deduplicated store.
+
+    Archival must never fail a job that already completed; any store problem
+    is logged and the raw working directory keeps serving as before.
+    """
+    try:
+        stored = report_store.ingest_directory(job_id, working_dir)
+        if stored:
+            logger.info("Archived %d artifacts for job %s", len(stored), job_id)
+    except Exception:  # pragma: no cover - archival is best-effort
+        logger.exception("Report store ingest failed for job %s", job_id)
+
+
+def _run_obfuscation(
+    job_id: str,
+    source_path: Path,
+    config: ObfuscationConfig,
+    platforms: Optional[list[Platform]] = None,
+) -> None:
     try:
         job_manager.update_job(job_id, status="running")
         progress_tracker.publish_sync(ProgressEvent(job_id=job_id, stage="running", progress=0.1, message="Compilation started"))
-        result = obfuscator.obfuscate(source_path, config, job_id=job_id)
+        if platforms:
+            result = obfuscator.obfuscate_multi(source_path, config, platforms, job_id=job_id)
+        else:
+            result = obfuscator.obfuscate(source_path, config, job_id=job_id)
         job_manager.update_job(job_id, status="completed", result=result)
         job_manager.attach_reports(job_id, result.get("report_paths", {}))
+        _archive_job(job_id, source_path.parent)
         progress_tracker.publish_sync(ProgressEvent(job_id=job_id, stage="completed", progress=1.0, message="Obfuscation completed"))
     except Exception as exc:  # pragma: no cover - background tasks
         logger.exception("Job %s failed", job_id)
         job_manager.update_job(job_id, status="failed", error=str(exc))
         progress_tracker.publish_sync(ProgressEvent(job_id=job_id, stage="failed", progress=1.0, message=str(exc)))
+    finally:
+        # Persist the per-stage timeline so late/offline clients can still
+        # see where the time went after the WebSocket stream is gone.
+        try:
+            job_manager.update_job(
+                job_id,
+                progress_events=[event.to_dict() for event in progress_tracker.snapshot(job_id)],
+            )
+        except JobNotFoundError:
+            pass
 
 
 @app.post("/api/obfuscate/sync")
@@ -272,8 +414,10 @@ async def api_obfuscate_sync(
     """Synchronous obfuscation - process immediately and return binary."""
     _validate_source_size(payload.source_code)
 
-    # Always compile for Linux, regardless of what user selected
+    # Always compile for Linux, regardless of what user selected; the sync
+    # endpoint returns one binary, so no fan-out either.
     payload.platform = Platform.LINUX
+    payload.platforms = None
 
     job = job_manager.create_job({"filename": payload.filename, "platform": payload.platform.value})
     working_dir = report_base / job.job_id
@@ -288,6 +432,7 @@ async def api_obfuscate_sync(
         result = obfuscator.obfuscate(source_path, config, job_id=job.job_id)
         job_manager.update_job(job.job_id, status="completed", result=result)
         job_manager.attach_reports(job.job_id, result.get("report_paths", {}))
+        _archive_job(job.job_id, working_dir)
 
         binary_path = Path(result.get("output_file", ""))
         if not binary_path.exists():
@@ -308,20 +453,93 @@ async def api_obfuscate_sync(
 @app.post("/api/obfuscate")
 async def api_obfuscate(
     payload: ObfuscateRequest,
-    background: BackgroundTasks,
 ):
-    """Async obfuscation - queue job and process in background."""
+    """Async obfuscation - queue job on the bounded worker pool."""
     _validate_source_size(payload.source_code)
     job = job_manager.create_job({"filename": payload.filename, "platform": payload.platform.value})
-    await progress_tracker.publish(ProgressEvent(job.job_id, "queued", 0.0, "Job queued"))
     working_dir = report_base / job.job_id
     ensure_directory(working_dir)
     source_filename = _sanitize_filename(payload.filename)
     source_path = (working_dir / source_filename).resolve()
     _decode_source(payload.source_code, source_path)
+
+    if job_queue:
+        # Hand the whole job to the broker: the payload is self-contained so
+        # any worker on any machine can build it from scratch.
+        job_queue.enqueue(job.job_id, {
+            "filename": source_filename,
+            "source_b64": base64.b64encode(source_path.read_bytes()).decode("ascii"),
+            "config": _config_data_from_request(payload, working_dir),
+            "platforms": [p.value for p in payload.platforms] if payload.platforms else [],
+        })
+        await progress_tracker.publish(ProgressEvent(job.job_id, "queued", 0.0, "Job queued"))
+        return {"job_id": job.job_id, "status": job.status, "queue": job_queue.stats()}
+
     config = _build_config_from_request(payload, working_dir)
-    background.add_task(_run_obfuscation, job.job_id, source_path, config)
-    return {"job_id": job.job_id, "status": job.status}
+    try:
+        job_executor.submit(
+            job.job_id, _run_obfuscation, job.job_id, source_path, config, payload.platforms
+        )
+    except QueueFullError as exc:
+        job_manager.update_job(job.job_id, status="rejected", error=str(exc))
+        raise HTTPException(
+            status_code=429,
+            detail=str(exc),
+            headers={"Retry-After": "30"},
+        )
+    await progress_tracker.publish(ProgressEvent(job.job_id, "queued", 0.0, "Job queued"))
+    return {"job_id": job.job_id, "status": job.status, "queue": job_executor.stats()}
+
+
+@app.post("/api/obfuscate/stream")
+async def api_obfuscate_stream(
+    request: Request,
+    filename: str,
+):
+    """Streaming obfuscation upload.
+
+    The raw source goes in the request body (Content-Type: application/
+    octet-stream) and is written to the job workspace chunk by chunk, so a
+    50 MB TU costs 50 MB on disk instead of ~3x that in base64/JSON churn.
+    Obfuscation options ride in an optional X-Obfuscation-Config header
+    holding the same JSON object as the 'config' field of /api/obfuscate;
+    'custom_flags' and 'report_formats' keys are honoured alongside it.
+    """
+    config_header = request.headers.get("x-obfuscation-config")
+    try:
+        config_data = json.loads(config_header) if config_header else {}
+        payload = ObfuscateRequest(
+            source_code="",
+            filename=filename,
+            platform=Platform.LINUX,
+            config=ConfigModel(**{
+                k: v for k, v in config_data.items()
+                if k not in ("custom_flags", "report_formats")
+            }),
+            report_formats=config_data.get("report_formats") or ["json", "markdown"],
+            custom_flags=config_data.get("custom_flags"),
+        )
+    except (ValueError, TypeError) as exc:
+        raise HTTPException(status_code=422, detail=f"Invalid X-Obfuscation-Config: {exc}")
+
+    job = job_manager.create_job({"filename": filename, "platform": payload.platform.value})
+    working_dir = report_base / job.job_id
+    ensure_directory(working_dir)
+    source_path = (working_dir / _sanitize_filename(filename)).resolve()
+    try:
+        size = await _stream_to_file(request, source_path)
+    except HTTPException as exc:
+        job_manager.update_job(job.job_id, status="rejected", error=exc.detail)
+        raise
+    job_manager.update_job(job.job_id, source_bytes=size)
+    config = _build_config_from_request(payload, working_dir)
+    try:
+        job_executor.submit(job.job_id, _run_obfuscation, job.job_id, source_path, config)
+    except QueueFullError as exc:
+        job_manager.update_job(job.job_id, status="rejected", error=str(exc))
+        raise HTTPException(status_code=429, detail=str(exc), headers={"Retry-After": "30"})
+    await progress_tracker.publish(ProgressEvent(job.job_id, "queued", 0.0, "Job queued"))
+    return {"job_id": job.job_id, "status": "pending", "source_bytes": size, "queue": job_executor.stats()}
 
 
 @app.get("/api/analyze/{job_id}")
@@ -354,17 +572,23 @@ async def api_compare(payload: CompareRequest):
 
 
 @app.get("/api/jobs")
-async def api_list_jobs():
-    records = job_manager.list_jobs()
-    payload = [
-        {
-            "job_id": job.job_id,
-            "status": job.status,
-            "created_at": job.created_at.isoformat() + "Z",
-            "updated_at": job.updated_at.isoformat() + "Z",
-        }
-        for job in records
-    ]
+async def api_list_jobs(status: Optional[str] = None, limit: int = 100, offset: int = 0):
+    limit = min(max(limit, 1), 500)
+    records = job_manager.list_jobs(status=status, limit=limit, offset=max(offset, 0))
+    payload = {
+        "total": job_manager.count_jobs(status=status),
+        "limit": limit,
+        "offset": max(offset, 0),
+        "jobs": [
+            {
+                "job_id": job.job_id,
+                "status": job.status,
+                "created_at": job.created_at.isoformat() + "Z",
+                "updated_at": job.updated_at.isoformat() + "Z",
+            }
+            for job in records
+        ],
+    }
     return JSONResponse(payload)
 
 
@@ -378,24 +602,29 @@ async def api_get_report(job_id: str, fmt: str = "json"):
     if not report_path:
         raise HTTPException(status_code=404, detail="Report not available")
     path = Path(report_path)
-    if not path.exists():
+    if path.exists():
+        return FileResponse(path)
+    # Raw working directory is gone (cleaned up or expired from disk) -
+    # serve the archived copy from the content-addressed store.
+    try:
+        name = str(path.relative_to(report_base / job_id))
+    except ValueError:
+        name = path.name
+    data = report_store.read(job_id, name)
+    if data is None:
         raise HTTPException(status_code=404, detail="Report file missing")
-    return FileResponse(path)
+    media_types = {"json": "application/json", "html": "text/html", "markdown": "text/markdown"}
+    return Response(content=data, media_type=media_types.get(fmt, "application/octet-stream"))
 
 
 @app.websocket("/ws/jobs/{job_id}")
 async def websocket_progress(websocket: WebSocket, job_id: str):
     await websocket.accept()
     try:
+        # Replays the job's event history first, then streams live events and
+        # closes after the terminal (completed/failed) event.
         async for event in progress_tracker.subscribe(job_id):
-            await websocket.send_json(
-                {
-                    "job_id": job_id,
-                    "stage": event.stage,
-                    "progress": event.progress,
-                    "message": event.message,
-                }
-            )
+            await websocket.send_json(event.to_dict())
     except WebSocketDisconnect:
         logger.info("WebSocket disconnected for job %s", job_id)
 
@@ -465,7 +694,7 @@ async def api_download_binary(job_id: str):
 
 @app.get("/api/health")
 async def api_health():
-    return {"status": "ok"}
+    return {"status": "ok", "queue": job_executor.stats()}
 
 
 @app.get("/api/flags")
@@ -19,8 +19,15 @@ from core import (
     analyze_binary,
     compare_binaries,
 )
-from core.batch import load_batch_config
-from core.config import AdvancedConfiguration, OutputConfiguration, SymbolObfuscationConfiguration
+from core.batch import BatchObfuscator, load_batch_config
+from core.incremental import IncrementalObfuscator
+from core.config import (
+    AdvancedConfiguration,
+    OutputConfiguration,
+    ProfileGuidedConfiguration,
+    StringEncryptionConfiguration,
+    SymbolObfuscationConfiguration,
+)
 from core.exceptions import ObfuscationError
 from core.utils import create_logger, load_yaml, normalize_flags_and_passes
 
@@ -38,18 +45,35 @@ def _build_config(
     enable_bogus_cf: bool,
     enable_split: bool,
     enable_linear_mba: bool,
+    skip_functions: Optional[str],
+    only_functions: Optional[str],
+    mba_max_depth: Optional[int],
+    mba_growth_cap: Optional[int],
+    mba_loop_aware: bool,
     cycles: int,
     string_encryption: bool,
+    string_encryption_mode: str,
+    string_encryption_lazy: bool,
+    string_encryption_simd: bool,
+    string_encryption_packed: bool,
+    string_encryption_dedup: bool,
     fake_loops: int,
+    verify_decoy_overhead: bool,
+    decoy_overhead_threshold: float,
     enable_symbol_obfuscation: bool,
     symbol_algorithm: str,
     symbol_hash_length: int,
     symbol_prefix: str,
     symbol_salt: Optional[str],
+    symbol_project_map: Optional[Path],
     report_formats: str,
     custom_flags: Optional[str],
     config_file: Optional[Path],
     custom_pass_plugin: Optional[Path],
+    no_cache: bool = False,
+    profile: bool = False,
+    profile_workload: Optional[str] = None,
+    profile_budget: float = 2.0,
 ) -> ObfuscationConfig:
     if config_file:
         data = load_yaml(config_file)
@@ -67,6 +91,11 @@ def _build_config(
         bogus_control_flow=enable_bogus_cf or detected_passes.get("boguscf", False),
         split=enable_split or detected_passes.get("split", False),
         linear_mba=enable_linear_mba or detected_passes.get("linear-mba", False),
+        skip_functions=[name.strip() for name in (skip_functions or "").split(",") if name.strip()],
+        only_functions=[name.strip() for name in (only_functions or "").split(",") if name.strip()],
+        mba_max_depth=mba_max_depth,
+        mba_growth_cap_percent=mba_growth_cap,
+        mba_loop_aware=mba_loop_aware,
     )
     symbol_obf_config = SymbolObfuscationConfiguration(
         enabled=enable_symbol_obfuscation,
@@ -74,12 +103,24 @@ def _build_config(
         hash_length=symbol_hash_length,
         prefix_style=symbol_prefix,
         salt=symbol_salt,
+        project_map=str(symbol_project_map) if symbol_project_map else None,
+    )
+    string_enc_config = StringEncryptionConfiguration(
+        enabled=string_encryption,
+        mode=string_encryption_mode,
+        lazy=string_encryption_lazy,
+        simd=string_encryption_simd,
+        packed_table=string_encryption_packed,
+        deduplicate=string_encryption_dedup,
     )
     advanced = AdvancedConfiguration(
         cycles=cycles,
         string_encryption=string_encryption,
         fake_loops=fake_loops,
+        verify_decoy_overhead=verify_decoy_overhead,
+        decoy_overhead_threshold_percent=decoy_overhead_threshold,
         symbol_obfuscation=symbol_obf_config,
+        string_encryption_config=string_enc_config,
     )
     output_config = OutputConfiguration(directory=output, report_formats=report_formats.split(","))
     return ObfuscationConfig(
@@ -90,6 +131,12 @@ def _build_config(
         advanced=advanced,
         output=output_config,
         custom_pass_plugin=custom_pass_plugin,
+        enable_cache=not no_cache,
+        profile=profile,
+        profile_guided=ProfileGuidedConfiguration(
+            workload=profile_workload,
+            overhead_budget_percent=profile_budget,
+        ),
     )
 
 
@@ -98,24 +145,42 @@ def compile(
     input_file: Path = typer.Argument(..., help="C/C++ source file to obfuscate"),
     output: Path = typer.Option(Path("./obfuscated"), help="Output directory"),
     platform: Platform = typer.Option(Platform.LINUX, case_sensitive=False, help="Target platform"),
-    level: int = typer.Option(3, min=1, max=5, help="Obfuscation level 1-5"),
+    platforms: Optional[str] = typer.Option(None, "--platforms", help="Comma-separated target platforms (e.g. linux,windows); source transforms run once, per-platform builds run concurrently into <output>/<platform>/"),
+    level: int = typer.Option(3, min=0, max=5, help="Obfuscation level 1-5, or 0 for adaptive (profile-guided; requires --profile-workload)"),
     enable_flattening: bool = typer.Option(False, "--enable-flattening", help="Enable control flow flattening"),
     enable_substitution: bool = typer.Option(False, "--enable-substitution", help="Enable instruction substitution"),
     enable_bogus_cf: bool = typer.Option(False, "--enable-bogus-cf", help="Enable bogus control flow"),
     enable_split: bool = typer.Option(False, "--enable-split", help="Enable basic block splitting"),
     enable_linear_mba: bool = typer.Option(False, "--enable-linear-mba", help="Enable Linear MBA bitwise obfuscation"),
+    skip_functions: Optional[str] = typer.Option(None, "--skip-functions", help="Comma-separated function names excluded from all OLLVM passes (hot paths)"),
+    only_functions: Optional[str] = typer.Option(None, "--only-functions", help="Comma-separated function names; OLLVM passes apply only to these"),
+    mba_max_depth: Optional[int] = typer.Option(None, "--mba-max-depth", min=1, help="Maximum linear-MBA rewrite depth (default: plugin default)"),
+    mba_growth_cap: Optional[int] = typer.Option(None, "--mba-growth-cap", min=0, help="Per-function instruction growth cap for linear-MBA, in percent"),
+    mba_loop_aware: bool = typer.Option(False, "--mba-loop-aware", help="Lower linear-MBA rewrite depth inside nested loops"),
     cycles: int = typer.Option(1, help="Number of obfuscation cycles"),
     string_encryption: bool = typer.Option(False, "--string-encryption", help="Enable string encryption"),
-    fake_loops: int = typer.Option(0, "--fake-loops", help="Number of fake loops to insert"),
+    string_encryption_mode: str = typer.Option("heap", "--string-encryption-mode", help="String encryption emission mode (heap, arena, constexpr)"),
+    string_encryption_lazy: bool = typer.Option(False, "--string-encryption-lazy", help="Decrypt const globals on first use instead of at startup"),
+    string_encryption_simd: bool = typer.Option(False, "--string-encryption-simd", help="Emit vectorized XOR decryption kernel (SSE2/AVX2/NEON with scalar fallback)"),
+    string_encryption_packed: bool = typer.Option(False, "--string-encryption-packed", help="Pack encrypted strings into one blob with an offset/length/key table"),
+    string_encryption_dedup: bool = typer.Option(True, "--string-encryption-dedup/--no-string-encryption-dedup", help="Intern identical literals into one encrypted entry"),
+    fake_loops: int = typer.Option(0, "--fake-loops", help="Number of opaque-predicate decoy loops to insert (never executed)"),
+    verify_decoy_overhead: bool = typer.Option(False, "--verify-decoy-overhead", help="Time baseline vs output to confirm the decoys are runtime-free (executes both binaries)"),
+    decoy_overhead_threshold: float = typer.Option(1.0, "--decoy-overhead-threshold", help="Allowed runtime overhead in percent for the decoy verification"),
     enable_symbol_obfuscation: bool = typer.Option(False, "--enable-symbol-obfuscation", help="Enable cryptographic symbol renaming"),
     symbol_algorithm: str = typer.Option("sha256", help="Symbol hash algorithm (sha256, blake2b, siphash)"),
     symbol_hash_length: int = typer.Option(12, help="Symbol hash length"),
     symbol_prefix: str = typer.Option("typed", help="Symbol prefix style (none, typed, underscore)"),
     symbol_salt: Optional[str] = typer.Option(None, help="Custom salt for symbol hashing"),
+    symbol_project_map: Optional[Path] = typer.Option(None, "--symbol-project-map", help="Project-level symbol map; merges per-TU maps and enforces consistent renaming across TUs"),
     report_formats: str = typer.Option("json", help="Report formats (comma separated)"),
     custom_flags: Optional[str] = typer.Option(None, help="Additional compiler flags"),
     config_file: Optional[Path] = typer.Option(None, help="Load configuration from YAML/JSON file"),
     custom_pass_plugin: Optional[Path] = typer.Option(None, help="Path to custom LLVM pass plugin"),
+    no_cache: bool = typer.Option(False, "--no-cache", help="Bypass the compilation cache"),
+    profile: bool = typer.Option(False, "--profile", help="Record per-stage and per-pass timings in the report"),
+    profile_workload: Optional[str] = typer.Option(None, "--profile-workload", help="Workload command for adaptive level 0; '{binary}' expands to the instrumented binary path"),
+    profile_budget: float = typer.Option(2.0, "--profile-budget", help="Runtime overhead budget in percent for the adaptive level"),
 ):
     """Compile and obfuscate a source file."""
     try:
@@ -129,22 +194,43 @@ def compile(
             enable_bogus_cf=enable_bogus_cf,
             enable_split=enable_split,
             enable_linear_mba=enable_linear_mba,
+            skip_functions=skip_functions,
+            only_functions=only_functions,
+            mba_max_depth=mba_max_depth,
+            mba_growth_cap=mba_growth_cap,
+            mba_loop_aware=mba_loop_aware,
             cycles=cycles,
             string_encryption=string_encryption,
+            string_encryption_mode=string_encryption_mode,
+            string_encryption_lazy=string_encryption_lazy,
+            string_encryption_simd=string_encryption_simd,
+            string_encryption_packed=string_encryption_packed,
+            string_encryption_dedup=string_encryption_dedup,
             fake_loops=fake_loops,
+            verify_decoy_overhead=verify_decoy_overhead,
+            decoy_overhead_threshold=decoy_overhead_threshold,
             enable_symbol_obfuscation=enable_symbol_obfuscation,
             symbol_algorithm=symbol_algorithm,
             symbol_hash_length=symbol_hash_length,
             symbol_prefix=symbol_prefix,
             symbol_salt=symbol_salt,
+            symbol_project_map=symbol_project_map,
             report_formats=report_formats,
             custom_flags=custom_flags,
             config_file=config_file,
             custom_pass_plugin=custom_pass_plugin,
+            no_cache=no_cache,
+            profile=profile,
+            profile_workload=profile_workload,
+            profile_budget=profile_budget,
         )
         reporter = ObfuscationReport(config.output.directory)
         obfuscator = LLVMObfuscator(reporter=reporter)
-        result = obfuscator.obfuscate(input_file, config)
+        if platforms:
+            targets = [Platform.from_string(p.strip()) for p in platforms.split(",") if p.strip()]
+            result = obfuscator.obfuscate_multi(input_file, config, targets)
+        else:
+            result = obfuscator.obfuscate(input_file, config)
         typer.echo(json.dumps(result, indent=2))
     except ObfuscationError as exc:
         logger.error("Obfuscation failed: %s", exc)
@@ -174,25 +260,107 @@ def compare(
     typer.echo(json.dumps(result, indent=2))
 
 
+@app.command()
+def worker(
+    queue_db: Path = typer.Option(Path("./queue.db"), help="Shared job queue database (must be reachable by the API node)"),
+    job_db: Path = typer.Option(Path("./jobs.db"), help="Shared job registry database"),
+    report_store_dir: Optional[Path] = typer.Option(None, "--report-store", help="Shared report store root; finished artifacts are pushed there"),
+    work_dir: Path = typer.Option(Path("./worker-jobs"), help="Local scratch directory for builds"),
+    worker_id: Optional[str] = typer.Option(None, help="Worker identity (default: hostname-pid)"),
+    poll_interval: float = typer.Option(2.0, help="Seconds between queue polls when idle"),
+    once: bool = typer.Option(False, "--once", help="Process at most one job and exit (for testing)"),
+):
+    """Run a distributed obfuscation worker against the shared job queue."""
+    import signal
+
+    from core.job_manager import JobManager
+    from core.job_queue import JobQueue
+    from core.report_store import ReportStore
+    from core.worker import ObfuscationWorker
+
+    engine = ObfuscationWorker(
+        queue=JobQueue(db_path=queue_db),
+        job_manager=JobManager(db_path=job_db),
+        report_store=ReportStore(report_store_dir) if report_store_dir else None,
+        work_root=work_dir,
+        worker_id=worker_id,
+        poll_interval=poll_interval,
+    )
+    if once:
+        handled = engine.run_once()
+        typer.echo("Processed 1 job" if handled else "Queue empty")
+        return
+    signal.signal(signal.SIGTERM, lambda *_: engine.stop())
+    signal.signal(signal.SIGINT, lambda *_: engine.stop())
+    engine.run_forever()
+
+
+@app.command()
+def benchmark(
+    examples_dir: Path = typer.Argument(Path("./examples"), help="Directory of benchmark kernels (*.c)"),
+    output: Path = typer.Option(Path("./benchmark-results.json"), help="Where to write the suite JSON"),
+    build_dir: Path = typer.Option(Path("./benchmark-build"), help="Scratch directory for the per-combination builds"),
+    warmup: int = typer.Option(1, min=0, help="Warmup runs per binary (not timed)"),
+    repetitions: int = typer.Option(5, min=1, help="Timed runs per binary; the median is reported"),
+    max_combo_size: Optional[int] = typer.Option(None, "--max-combo-size", min=0, help="Limit pass combinations to at most this many passes (default: all 32)"),
+    baseline: Optional[Path] = typer.Option(None, "--baseline", help="Stored suite JSON to compare against; regressions fail the run"),
+    tolerance: float = typer.Option(10.0, "--tolerance", help="Allowed median-runtime increase over the baseline, in percent"),
+):
+    """Measure runtime and size overhead of every pass combination."""
+    from core.benchmark import BenchmarkRunner, compare_baselines, write_suite
+
+    try:
+        runner = BenchmarkRunner(
+            examples_dir=examples_dir,
+            output_dir=build_dir,
+            warmup=warmup,
+            repetitions=repetitions,
+            max_combo_size=max_combo_size,
+        )
+        suite = runner.run()
+    except ObfuscationError as exc:
+        logger.error("Benchmark run failed: %s", exc)
+        raise typer.Exit(code=1)
+
+    write_suite(suite, output)
+    typer.echo(f"Suite written to {output} ({len(suite['results'])} measurements)")
+
+    mismatches = [r for r in suite["results"] if r.get("output_matches_baseline") is False]
+    if mismatches:
+        for entry in mismatches:
+            logger.error("Output mismatch: %s [%s]", entry["kernel"], entry["passes"])
+        raise typer.Exit(code=1)
+
+    if baseline:
+        comparison = compare_baselines(suite, json.loads(baseline.read_text()), tolerance)
+        typer.echo(json.dumps(comparison, indent=2))
+        if comparison["regressions"]:
+            raise typer.Exit(code=1)
+
+
 @app.command()
 def batch(
     config_path: Path = typer.Argument(..., help="YAML configuration for batch processing"),
+    workers: Optional[int] = typer.Option(None, "--workers", "-j", help="Worker processes (default: CPU count)"),
+    fail_fast: bool = typer.Option(False, "--fail-fast", help="Stop scheduling new jobs after the first failure"),
+    incremental: bool = typer.Option(False, "--incremental", help="Only re-obfuscate TUs whose source or config changed"),
+    state_file: Path = typer.Option(
+        Path("./.obf-incremental.json"), "--state-file", help="Incremental manifest location"
+    ),
 ):
-    """Run batch obfuscation jobs using YAML configuration."""
+    """Run batch obfuscation jobs in parallel using YAML configuration."""
     jobs = load_batch_config(config_path)
     typer.echo(f"Loaded {len(jobs)} jobs from {config_path}")
-    reporter = ObfuscationReport(Path("./reports"))
-    obfuscator = LLVMObfuscator(reporter=reporter)
-    for job in jobs:
-        source = job["source"]
-        obf_config: ObfuscationConfig = job["config"]
-        obf_config.output.directory = job["output"]
-        typer.echo(f"Processing {source} -> {obf_config.output.directory}")
-        try:
-            result = obfuscator.obfuscate(source, obf_config)
-            typer.echo(json.dumps(result, indent=2))
-        except ObfuscationError as exc:
-            logger.error("Batch job failed for %s: %s", source, exc)
+    if incremental:
+        engine = IncrementalObfuscator(
+            workers=workers, fail_fast=fail_fast, report_dir=Path("./reports"), state_file=state_file
+        )
+    else:
+        engine = BatchObfuscator(workers=workers, fail_fast=fail_fast, report_dir=Path("./reports"))
+    summary = engine.run(jobs)
+    typer.echo(json.dumps(summary.to_dict(), indent=2))
+    if summary.failed:
+        raise typer.Exit(code=1)
 
 
 if __name__ == "__main__":
@@ -1,10 +1,16 @@
 from __future__ import annotations
 
+import time
+from concurrent.futures import FIRST_COMPLETED, ProcessPoolExecutor, wait
+from dataclasses import dataclass, field
 from pathlib import Path
-from typing import Dict, List
+from typing import Dict, List, Optional
 
 from .config import ObfuscationConfig
-from .utils import load_yaml
+from .exceptions import ObfuscationError
+from .obfuscator import LLVMObfuscator
+from .reporter import ObfuscationReport
+from .utils import create_logger, get_timestamp, load_yaml, require_tool, write_json
 
 
 def load_batch_config(config_path: Path) -> List[Dict]:
@@ -21,3 +27,214 @@ def load_batch_config(config_path: Path) -> List[Dict]:
             "output": destination,
         })
     return normalized
+
+
+@dataclass
+class BatchJobResult:
+    source: Path
+    status: str  # "succeeded", "failed", "skipped"
+    duration_seconds: float = 0.0
+    result: Optional[Dict] = None
+    error: Optional[str] = None
+
+
+@dataclass
+class BatchSummary:
+    total: int
+    succeeded: int
+    failed: int
+    skipped: int
+    wall_time_seconds: float
+    results: List[BatchJobResult] = field(default_factory=list)
+    # Jobs satisfied from the incremental manifest without rebuilding
+    # (populated by IncrementalObfuscator, always 0 for plain batch runs).
+    reused: int = 0
+
+    def to_dict(self) -> Dict:
+        return {
+            "total": self.total,
+            "succeeded": self.succeeded,
+            "failed": self.failed,
+            "skipped": self.skipped,
+            "reused": self.reused,
+            "wall_time_seconds": round(self.wall_time_seconds, 3),
+            "jobs": [
+                {
+                    "source": str(r.source),
+                    "status": r.status,
+                    "duration_seconds": round(r.duration_seconds, 3),
+                    "output_file": (r.result or {}).get("output_file"),
+                    "error": r.error,
+                }
+                for r in self.results
+            ],
+        }
+
+
+def _run_batch_job(job: Dict, report_dir: Path) -> BatchJobResult:
+    """Execute one obfuscation job. Runs inside a worker process.
+
+    The LLVMObfuscator is constructed here rather than in the parent so each
+    worker owns its own logger and reporter; only the job dict (source path,
+    config, output dir) crosses the process boundary.
+    """
+    source: Path = job["source"]
+    config: ObfuscationConfig = job["config"]
+    config.output.directory = job["output"]
+    started = time.time()
+    try:
+        obfuscator = LLVMObfuscator(reporter=ObfuscationReport(report_dir))
+        result = obfuscator.obfuscate(source, config)
+        return BatchJobResult(
+            source=source,
+            status="succeeded",
+            duration_seconds=time.time() - started,
+            result=result,
+        )
+    except ObfuscationError as exc:
+        return BatchJobResult(
+            source=source,
+            status="failed",
+            duration_seconds=time.time() - started,
+            error=str(exc),
+        )
+    except Exception as exc:  # pragma: no cover - defensive
+        return BatchJobResult(
+            source=source,
+            status="failed",
+            duration_seconds=time.time() - started,
+            error=f"{type(exc).__name__}: {exc}",
+        )
+
+
+class BatchObfuscator:
+    """Run a manifest of obfuscation jobs across a process pool.
+
+    Scheduling is per-file with idle workers pulling the next job as soon as
+    they finish their current one, so a flattening-heavy TU that takes 100x
+    longer than its neighbours never stalls the rest of the pool. Jobs are
+    submitted largest-source-first to keep the long tail at the front of the
+    schedule. Toolchain and plugin detection happen once in the parent and
+    are handed to the workers through the job configs.
+    """
+
+    def __init__(
+        self,
+        workers: Optional[int] = None,
+        fail_fast: bool = False,
+        report_dir: Path = Path("./reports"),
+    ) -> None:
+        self.logger = create_logger(__name__)
+        self.workers = workers
+        self.fail_fast = fail_fast
+        self.report_dir = report_dir
+
+    def run(self, jobs: List[Dict]) -> BatchSummary:
+        started = time.time()
+        if not jobs:
+            return BatchSummary(0, 0, 0, 0, 0.0)
+
+        self._resolve_shared_toolchain(jobs)
+        ordered = sorted(jobs, key=self._source_size, reverse=True)
+
+        if self.workers == 1 or len(ordered) == 1:
+            results = self._run_serial(ordered)
+        else:
+            results = self._run_pool(ordered)
+
+        summary = BatchSummary(
+            total=len(ordered),
+            succeeded=sum(1 for r in results if r.status == "succeeded"),
+            failed=sum(1 for r in results if r.status == "failed"),
+            skipped=sum(1 for r in results if r.status == "skipped"),
+            wall_time_seconds=time.time() - started,
+            results=results,
+        )
+        self._write_summary(summary)
+        return summary
+
+    # Internal --------------------------------------------------------------
+
+    def _resolve_shared_toolchain(self, jobs: List[Dict]) -> None:
+        """Detect clang and the bundled plugin once instead of per worker."""
+        require_tool("clang")
+        needs_plugin = any(
+            job["config"].passes.enabled_passes() and not job["config"].custom_pass_plugin
+            for job in jobs
+        )
+        if not needs_plugin:
+            return
+        probe = LLVMObfuscator()
+        for job in jobs:
+            config: ObfuscationConfig = job["config"]
+            if config.passes.enabled_passes() and not config.custom_pass_plugin:
+                plugin = probe._get_bundled_plugin_path(config.platform)
+                if plugin:
+                    config.custom_pass_plugin = plugin
+
+    @staticmethod
+    def _source_size(job: Dict) -> int:
+        try:
+            return job["source"].stat().st_size
+        except OSError:
+            return 0
+
+    def _run_pool(self, jobs: List[Dict]) -> List[BatchJobResult]:
+        results: List[BatchJobResult] = []
+        with ProcessPoolExecutor(max_workers=self.workers) as pool:
+            pending = {
+                pool.submit(_run_batch_job, job, self.report_dir): job for job in jobs
+            }
+            while pending:
+                done, _ = wait(pending, return_when=FIRST_COMPLETED)
+                for future in done:
+                    job = pending.pop(future)
+                    try:
+                        result = future.result()
+                    except Exception as exc:  # worker died (e.g. OOM kill)
+                        result = BatchJobResult(
+                            source=job["source"],
+                            status="failed",
+                            error=f"worker crashed: {exc}",
+                        )
+                    results.append(result)
+                    if result.status == "failed":
+                        self.logger.error("Batch job failed for %s: %s", result.source, result.error)
+                        if self.fail_fast:
+                            for remaining in pending:
+                                remaining.cancel()
+                            for skipped_job in pending.values():
+                                results.append(BatchJobResult(
+                                    source=skipped_job["source"],
+                                    status="skipped",
+                                    error="skipped after earlier failure (--fail-fast)",
+                                ))
+                            pending.clear()
+        return results
+
+    def _run_serial(self, jobs: List[Dict]) -> List[BatchJobResult]:
+        """Single-worker path: run in-process, stopping early under fail-fast."""
+        results: List[BatchJobResult] = []
+        failed = False
+        for job in jobs:
+            if failed and self.fail_fast:
+                results.append(BatchJobResult(
+                    source=job["source"],
+                    status="skipped",
+                    error="skipped after earlier failure (--fail-fast)",
+                ))
+                continue
+            result = _run_batch_job(job, self.report_dir)
+            if result.status == "failed":
+                self.logger.error("Batch job failed for %s: %s", result.source, result.error)
+                failed = True
+            results.append(result)
+        return results
+
+    def _write_summary(self, summary: BatchSummary) -> None:
+        path = self.report_dir / f"batch_{get_timestamp().replace(':', '-')}.json"
+        try:
+            write_json(path, summary.to_dict())
+            self.logger.info("Batch summary written to %s", path)
+        except OSError as exc:  # pragma: no cover - defensive
+            self.logger.warning("Could not write batch summary: %s", exc)
@@ -0,0 +1,203 @@
+"""
+Runtime-overhead benchmark suite over the example kernels.
+
+The README quotes overhead figures for the passes but nothing in the repo
+reproduced them. This harness does: every kernel in examples/ is obfuscated
+at every pass combination, the resulting binaries are timed with warmup and
+repetitions against the no-pass build, and the runtime and size overhead per
+pass mix lands in a JSON baseline. A stored baseline from a previous run can
+be compared against to catch regressions — the intended workflow before
+upgrading the bundled plugin binaries.
+
+Every obfuscated build must print the same stdout as the no-pass build;
+a mismatch is reported as a correctness failure, not an overhead number.
+"""
+
+from __future__ import annotations
+
+import itertools
+import statistics
+import subprocess
+import time
+from pathlib import Path
+from typing import Dict, List, Optional
+
+from .config import (
+    ObfuscationConfig,
+    ObfuscationLevel,
+    OutputConfiguration,
+    PassConfiguration,
+)
+from .exceptions import ObfuscationError
+from .obfuscator import LLVMObfuscator
+from .utils import create_logger, ensure_directory, get_timestamp, write_json
+
+logger = create_logger(__name__)
+
+# The boolean pass toggles on PassConfiguration, in a stable order so combo
+# labels are reproducible across runs.
+PASS_FIELDS = ["flattening", "substitution", "bogus_control_flow", "split", "linear_mba"]
+
+
+def pass_combinations(max_size: Optional[int] = None) -> List[List[str]]:
+    """All subsets of the pass toggles, empty set (the baseline) first."""
+    combos: List[List[str]] = []
+    for size in range(0, len(PASS_FIELDS) + 1):
+        if max_size is not None and size > max_size:
+            break
+        combos.extend(list(combo) for combo in itertools.combinations(PASS_FIELDS, size))
+    return combos
+
+
+def combo_label(combo: List[str]) -> str:
+    return "+".join(combo) if combo else "none"
+
+
+class BenchmarkRunner:
+    """Build and time every (kernel, pass combination) pair."""
+
+    RUN_TIMEOUT = 120
+
+    def __init__(
+        self,
+        examples_dir: Path,
+        output_dir: Path,
+        warmup: int = 1,
+        repetitions: int = 5,
+        max_combo_size: Optional[int] = None,
+    ) -> None:
+        self.logger = create_logger(__name__)
+        self.examples_dir = examples_dir
+        self.output_dir = output_dir
+        self.warmup = warmup
+        self.repetitions = repetitions
+        self.max_combo_size = max_combo_size
+
+    def run(self) -> Dict:
+        kernels = sorted(self.examples_dir.glob("*.c"))
+        if not kernels:
+            raise ObfuscationError(f"No benchmark kernels found in {self.examples_dir}")
+        combos = pass_combinations(self.max_combo_size)
+        suite: Dict = {
+            "timestamp": get_timestamp(),
+            "warmup": self.warmup,
+            "repetitions": self.repetitions,
+            "kernels": [kernel.name for kernel in kernels],
+            "results": [],
+        }
+        for kernel in kernels:
+            suite["results"].extend(self._run_kernel(kernel, combos))
+        return suite
+
+    # Internal ---------------------------------------------------------------
+
+    def _run_kernel(self, kernel: Path, combos: List[List[str]]) -> List[Dict]:
+        self.logger.info("Benchmarking %s across %d pass combinations", kernel.name, len(combos))
+        results: List[Dict] = []
+        baseline_runtime: Optional[float] = None
+        baseline_size: Optional[int] = None
+        baseline_stdout: Optional[bytes] = None
+        for combo in combos:
+            label = combo_label(combo)
+            try:
+                binary = self._build_variant(kernel, combo)
+            except ObfuscationError as exc:
+                self.logger.warning("%s [%s] failed to build: %s", kernel.name, label, exc)
+                results.append({"kernel": kernel.name, "passes": label, "error": str(exc)})
+                continue
+            stdout, runtime_ms = self._time_binary(binary)
+            size = binary.stat().st_size
+            entry: Dict = {
+                "kernel": kernel.name,
+                "passes": label,
+                "runtime_ms": round(runtime_ms, 3),
+                "size_bytes": size,
+            }
+            if not combo:
+                baseline_runtime, baseline_size, baseline_stdout = runtime_ms, size, stdout
+            else:
+                if baseline_runtime:
+                    entry["runtime_overhead_percent"] = round(
+                        (runtime_ms - baseline_runtime) / baseline_runtime * 100, 2
+                    )
+                if baseline_size:
+                    entry["size_overhead_percent"] = round(
+                        (size - baseline_size) / baseline_size * 100, 2
+                    )
+                entry["output_matches_baseline"] = stdout == baseline_stdout
+                if not entry["output_matches_baseline"]:
+                    self.logger.error(
+                        "%s [%s] output differs from the unobfuscated build", kernel.name, label
+                    )
+            results.append(entry)
+        return results
+
+    def _build_variant(self, kernel: Path, combo: List[str]) -> Path:
+        variant_dir = self.output_dir / kernel.stem / combo_label(combo)
+        ensure_directory(variant_dir)
+        config = ObfuscationConfig(
+            level=ObfuscationLevel.MEDIUM,
+            passes=PassConfiguration(**{name: True for name in combo}),
+            output=OutputConfiguration(directory=variant_dir),
+            enable_cache=False,
+        )
+        result = LLVMObfuscator().obfuscate(kernel, config)
+        return Path(result["output_file"])
+
+    def _time_binary(self, binary: Path) -> tuple:
+        """Median wall-clock runtime over the configured repetitions."""
+        stdout = b""
+        for _ in range(self.warmup):
+            subprocess.run([str(binary)], capture_output=True, timeout=self.RUN_TIMEOUT)
+        samples: List[float] = []
+        for _ in range(self.repetitions):
+            started = time.perf_counter()
+            completed = subprocess.run([str(binary)], capture_output=True, timeout=self.RUN_TIMEOUT)
+            samples.append((time.perf_counter() - started) * 1000)
+            stdout = completed.stdout
+        return stdout, statistics.median(samples)
+
+
+def compare_baselines(current: Dict, baseline: Dict, tolerance_percent: float = 10.0) -> Dict:
+    """Flag (kernel, passes) pairs that got slower than the stored baseline.
+
+    A regression is a median runtime more than tolerance_percent above the
+    baseline's for the same pair; pairs present on only one side are listed
+    separately rather than treated as failures.
+    """
+    def index(suite: Dict) -> Dict[str, Dict]:
+        return {
+            f"{entry['kernel']}::{entry['passes']}": entry
+            for entry in suite.get("results", [])
+            if "runtime_ms" in entry
+        }
+
+    current_index = index(current)
+    baseline_index = index(baseline)
+    regressions: List[Dict] = []
+    for key, entry in current_index.items():
+        reference = baseline_index.get(key)
+        if not reference:
+            continue
+        limit = reference["runtime_ms"] * (1 + tolerance_percent / 100)
+        if entry["runtime_ms"] > limit:
+            regressions.append({
+                "kernel": entry["kernel"],
+                "passes": entry["passes"],
+                "baseline_ms": reference["runtime_ms"],
+                "current_ms": entry["runtime_ms"],
+                "change_percent": round(
+                    (entry["runtime_ms"] - reference["runtime_ms"]) / reference["runtime_ms"] * 100, 2
+                ),
+            })
+    return {
+        "tolerance_percent": tolerance_percent,
+        "compared": len(set(current_index) & set(baseline_index)),
+        "only_in_current": sorted(set(current_index) - set(baseline_index)),
+        "only_in_baseline": sorted(set(baseline_index) - set(current_index)),
+        "regressions": sorted(regressions, key=lambda r: -r["change_percent"]),
+    }
+
+
+def write_suite(suite: Dict, path: Path) -> None:
+    write_json(path, suite)
@@ -0,0 +1,186 @@
+from __future__ import annotations
+
+import hashlib
+import json
+import os
+import shutil
+import time
+from pathlib import Path
+from typing import Dict, Optional
+
+from .config import ObfuscationConfig
+from .utils import create_logger, ensure_directory
+
+DEFAULT_CACHE_DIR = Path(os.environ.get(
+    "LLVM_OBFUSCATOR_CACHE_DIR",
+    str(Path.home() / ".cache" / "llvm-obfuscator"),
+))
+DEFAULT_MAX_ENTRIES = int(os.environ.get("LLVM_OBFUSCATOR_CACHE_MAX_ENTRIES", "256"))
+
+
+class CompilationCache:
+    """Content-addressed cache for obfuscation results.
+
+    Entries are keyed on a hash of the source text, the enabled passes, the
+    compiler/plugin fingerprint, and the ObfuscationConfig knobs that affect
+    the output. A hit returns the stored binary and report metrics without
+    invoking clang at all. Eviction is LRU over a configurable entry cap.
+    """
+
+    INDEX_NAME = "index.json"
+
+    def __init__(self, cache_dir: Optional[Path] = None, max_entries: int = DEFAULT_MAX_ENTRIES) -> None:
+        self.logger = create_logger(__name__)
+        self.cache_dir = cache_dir or DEFAULT_CACHE_DIR
+        self.max_entries = max_entries
+        ensure_directory(self.cache_dir)
+
+    # Key computation -------------------------------------------------------
+
+    @staticmethod
+    def _fingerprint_file(path: Optional[Path]) -> str:
+        """Cheap fingerprint of a toolchain binary: path, mtime, size."""
+        if not path:
+            return "none"
+        try:
+            stat = Path(path).stat()
+            return f"{path}:{int(stat.st_mtime)}:{stat.st_size}"
+        except OSError:
+            return f"{path}:missing"
+
+    def compute_key(self, source_text: str, config: ObfuscationConfig) -> str:
+        string_config = config.advanced.string_encryption_config
+        symbol_config = config.advanced.symbol_obfuscation
+        compiler_path = shutil.which("clang")
+        material = {
+            "passes": config.passes.enabled_passes(),
+            "pass_targeting": {
+                "skip": list(config.passes.skip_functions),
+                "only": list(config.passes.only_functions),
+            },
+            "mba_budget": {
+                "max_depth": config.passes.mba_max_depth,
+                "growth_cap_percent": config.passes.mba_growth_cap_percent,
+                "loop_aware": config.passes.mba_loop_aware,
+            },
+            "platform": config.platform.value,
+            "level": int(config.level),
+            "compiler_flags": list(config.compiler_flags),
+            "cycles": config.advanced.cycles,
+            "string_encryption": config.advanced.string_encryption,
+            "string_encryption_config": {
+                "mode": string_config.mode,
+                "lazy": string_config.lazy,
+                "simd": string_config.simd,
+                "packed_table": string_config.packed_table,
+                "deduplicate": string_config.deduplicate,
+            },
+            "fake_loops": config.advanced.fake_loops,
+            "symbol_obfuscation": {
+                "enabled": symbol_config.enabled,
+                "algorithm": symbol_config.algorithm,
+                "hash_length": symbol_config.hash_length,
+                "prefix_style": symbol_config.prefix_style,
+                "salt": symbol_config.salt,
+            },
+            "plugin": self._fingerprint_file(config.custom_pass_plugin),
+            "compiler": self._fingerprint_file(Path(compiler_path) if compiler_path else None),
+        }
+        hasher = hashlib.sha256()
+        hasher.update(source_text.encode("utf-8", errors="replace"))
+        hasher.update(json.dumps(material, sort_keys=True).encode("utf-8"))
+        return hasher.hexdigest()
+
+    # Index management ------------------------------------------------------
+
+    def _index_path(self) -> Path:
+        return self.cache_dir / self.INDEX_NAME
+
+    def _load_index(self) -> Dict[str, Dict]:
+        path = self._index_path()
+        if not path.exists():
+            return {}
+        try:
+            with path.open("r", encoding="utf-8") as f:
+                return json.load(f)
+        except (json.JSONDecodeError, OSError):
+            self.logger.warning("Cache index unreadable, starting fresh")
+            return {}
+
+    def _save_index(self, index: Dict[str, Dict]) -> None:
+        with self._index_path().open("w", encoding="utf-8") as f:
+            json.dump(index, f, indent=2)
+
+    def _entry_dir(self, key: str) -> Path:
+        return self.cache_dir / key[:2] / key
+
+    # Public API ------------------------------------------------------------
+
+    def lookup(self, key: str) -> Optional[Dict]:
+        """Return the stored job data for a key, or None on miss.
+
+        The returned dict contains "job_data" (the report metrics) and
+        "binary" (path to the cached output binary inside the cache).
+        """
+        entry_dir = self._entry_dir(key)
+        meta_path = entry_dir / "job_data.json"
+        binary_path = entry_dir / "binary"
+        if not meta_path.exists() or not binary_path.exists():
+            return None
+
+        index = self._load_index()
+        if key in index:
+            index[key]["last_used"] = time.time()
+            self._save_index(index)
+
+        try:
+            with meta_path.open("r", encoding="utf-8") as f:
+                job_data = json.load(f)
+        except (json.JSONDecodeError, OSError):
+            self.logger.warning("Corrupt cache entry %s, treating as miss", key)
+            return None
+        return {"job_data": job_data, "binary": binary_path}
+
+    def store(self, key: str, binary_path: Path, job_data: Dict) -> None:
+        if not binary_path.exists():
+            return
+        entry_dir = self._entry_dir(key)
+        ensure_directory(entry_dir)
+        shutil.copy2(binary_path, entry_dir / "binary")
+        with (entry_dir / "job_data.json").open("w", encoding="utf-8") as f:
+            json.dump(job_data, f, indent=2, default=str)
+
+        index = self._load_index()
+        now = time.time()
+        index[key] = {"created": now, "last_used": now}
+        self._evict(index)
+        self._save_index(index)
+
+    def restore_binary(self, key: str, destination: Path) -> bool:
+        """Copy the cached binary for a key to the requested destination."""
+        binary_path = self._entry_dir(key) / "binary"
+        if not binary_path.exists():
+            return False
+        ensure_directory(destination.parent)
+        shutil.copy2(binary_path, destination)
+        return True
+
+    def clear(self) -> None:
+        if self.cache_dir.exists():
+            shutil.rmtree(self.cache_dir)
+        ensure_directory(self.cache_dir)
+
+    # Internal --------------------------------------------------------------
+
+    def _evict(self, index: Dict[str, Dict]) -> None:
+        """Drop least-recently-used entries beyond the entry cap."""
+        if len(index) <= self.max_entries:
+            return
+        ordered = sorted(index.items(), key=lambda item: item[1].get("last_used", 0))
+        excess = len(index) - self.max_entries
+        for key, _ in ordered[:excess]:
+            entry_dir = self._entry_dir(key)
+            if entry_dir.exists():
+                shutil.rmtree(entry_dir, ignore_errors=True)
+            index.pop(key, None)
+            self.logger.debug("Evicted cache entry %s", key)
@@ -1,10 +1,136 @@
+"""
+Section-level binary diff engine.
+
+The comparer backs `/api/compare` and the release-regression workflow: every
+obfuscated release is diffed against the previous one to spot passes that
+suddenly stopped (or started) rewriting code. Instead of loading both files
+wholesale, BinaryComparer maps each binary's section layout via the native
+analyzer, chunks the section contents, and hashes the chunks in parallel -
+hashlib releases the GIL on large buffers, so a thread pool uses all cores.
+Per section it reports sizes, the size delta, and a similarity score; the
+symbol tables are compared as sets for overlap. Binaries the native parser
+rejects degrade to a whole-file diff treated as one pseudo-section.
+"""
+
 from __future__ import annotations
 
+import hashlib
+import mmap
+from concurrent.futures import ThreadPoolExecutor
 from pathlib import Path
-from typing import Dict
+from typing import Dict, List
 
+from .analyzer import BinaryAnalyzer, BinaryParseError
 from .config import CompareConfig
-from .utils import compute_entropy, get_file_size, write_json
+from .utils import compute_entropy, create_logger, get_file_size, write_json
+
+logger = create_logger(__name__)
+
+
+class BinaryComparer:
+    """Chunk-hash two binaries section by section and score their similarity."""
+
+    CHUNK_SIZE = 64 * 1024
+
+    def __init__(self, original: Path, obfuscated: Path) -> None:
+        self.original = original
+        self.obfuscated = obfuscated
+
+    def compare(self) -> Dict:
+        original_layout = self._layout(self.original)
+        obfuscated_layout = self._layout(self.obfuscated)
+
+        section_names = sorted(set(original_layout["sections"]) | set(obfuscated_layout["sections"]))
+        with open(self.original, "rb") as orig_f, open(self.obfuscated, "rb") as obf_f, \
+                mmap.mmap(orig_f.fileno(), 0, access=mmap.ACCESS_READ) as orig_mm, \
+                mmap.mmap(obf_f.fileno(), 0, access=mmap.ACCESS_READ) as obf_mm:
+            # One task per (section, side): chunk hashing is C-speed and
+            # GIL-free, so sections hash concurrently across cores.
+            with ThreadPoolExecutor() as pool:
+                original_futures = {
+                    name: pool.submit(self._chunk_hashes, orig_mm, *span)
+                    for name, span in original_layout["sections"].items()
+                }
+                obfuscated_futures = {
+                    name: pool.submit(self._chunk_hashes, obf_mm, *span)
+                    for name, span in obfuscated_layout["sections"].items()
+                }
+                original_hashes = {name: future.result() for name, future in original_futures.items()}
+                obfuscated_hashes = {name: future.result() for name, future in obfuscated_futures.items()}
+
+        sections = {}
+        weighted_similarity = weight_total = 0
+        for name in section_names:
+            orig_size = original_layout["sections"].get(name, (0, 0))[1]
+            obf_size = obfuscated_layout["sections"].get(name, (0, 0))[1]
+            similarity = self._similarity(
+                original_hashes.get(name, []), obfuscated_hashes.get(name, [])
+            )
+            sections[name] = {
+                "original_size": orig_size,
+                "obfuscated_size": obf_size,
+                "size_delta": obf_size - orig_size,
+                "similarity": similarity,
+            }
+            weight = max(orig_size, obf_size)
+            weighted_similarity += similarity * weight
+            weight_total += weight
+
+        return {
+            "sections": sections,
+            "overall_similarity": round(weighted_similarity / weight_total, 4) if weight_total else 1.0,
+            "symbol_overlap": self._symbol_overlap(
+                original_layout["symbol_names"], obfuscated_layout["symbol_names"]
+            ),
+        }
+
+    # Internal ---------------------------------------------------------------
+
+    def _layout(self, binary: Path) -> Dict:
+        """Native section layout; unparseable files become one pseudo-section."""
+        try:
+            return BinaryAnalyzer(binary).layout()
+        except BinaryParseError as exc:
+            logger.debug("No section layout for %s (%s); diffing whole file", binary, exc)
+            return {
+                "format": "raw",
+                "sections": {"(file)": (0, get_file_size(binary))},
+                "symbol_names": [],
+            }
+
+    @classmethod
+    def _chunk_hashes(cls, mm: mmap.mmap, offset: int, size: int) -> List[bytes]:
+        end = min(offset + size, len(mm))
+        return [
+            hashlib.blake2b(mm[start:min(start + cls.CHUNK_SIZE, end)], digest_size=16).digest()
+            for start in range(offset, end, cls.CHUNK_SIZE)
+        ]
+
+    @staticmethod
+    def _similarity(original: List[bytes], obfuscated: List[bytes]) -> float:
+        """Fraction of positionally matching chunk hashes.
+
+        Positional comparison (not set overlap) is deliberate: a pass that
+        rewrites code changes chunk contents in place, and that is exactly
+        the signal the regression diff looks for.
+        """
+        if not original and not obfuscated:
+            return 1.0
+        total = max(len(original), len(obfuscated))
+        matching = sum(1 for a, b in zip(original, obfuscated) if a == b)
+        return round(matching / total, 4)
+
+    @staticmethod
+    def _symbol_overlap(original: List[str], obfuscated: List[str]) -> Dict:
+        orig_set, obf_set = set(original), set(obfuscated)
+        union = orig_set | obf_set
+        shared = orig_set & obf_set
+        return {
+            "original_symbols": len(orig_set),
+            "obfuscated_symbols": len(obf_set),
+            "shared_symbols": len(shared),
+            "jaccard": round(len(shared) / len(union), 4) if union else 1.0,
+        }
 
 
 def compare_binaries(config: CompareConfig) -> Dict:
@@ -22,9 +148,10 @@ def compare_binaries(config: CompareConfig) -> Dict:
             "entropy": compute_entropy(obfuscated.read_bytes() if obfuscated.exists() else b""),
         },
         "size_delta": get_file_size(obfuscated) - get_file_size(original),
-        "entropy_delta": compute_entropy(obfuscated.read_bytes() if obfuscated.exists() else b"")
-        - compute_entropy(original.read_bytes() if original.exists() else b""),
     }
+    comparison["entropy_delta"] = comparison["obfuscated"]["entropy"] - comparison["original"]["entropy"]
+    if original.exists() and obfuscated.exists() and get_file_size(original) and get_file_size(obfuscated):
+        comparison.update(BinaryComparer(original, obfuscated).compare())
     if config.output:
         write_json(config.output, comparison)
     return comparison
@@ -25,6 +25,12 @@ class Platform(str, Enum):
 
 
 class ObfuscationLevel(int, Enum):
+    # Adaptive: per-function pass intensity decided from a profile of a
+    # user-supplied workload instead of a fixed global setting. Requires a
+    # ProfileGuidedConfiguration with a workload command; the hottest
+    # functions are excluded from the passes until the predicted overhead
+    # fits the configured budget.
+    ADAPTIVE = 0
     MINIMAL = 1
     LOW = 2
     MEDIUM = 3
@@ -39,6 +45,25 @@ class PassConfiguration:
     bogus_control_flow: bool = False
     split: bool = False
     linear_mba: bool = False
+    # Function-level pass targeting. skip_functions excludes the named
+    # functions from every enabled pass (hot loops that cannot afford the
+    # overhead); only_functions restricts the passes to exactly those names.
+    # Plumbed to the OLLVM plugin as opt flags; a plugin build without the
+    # flags falls back to whole-binary application with a report warning.
+    # Source-level `__attribute__((annotate("no<pass>")))` markers are honored
+    # by the plugin directly and need no configuration here.
+    skip_functions: List[str] = field(default_factory=list)
+    only_functions: List[str] = field(default_factory=list)
+    # Linear-MBA cost budget. Unbounded MBA rewriting turns every add/xor in
+    # a hot loop into an expression tree and can cost an order of magnitude
+    # on arithmetic-heavy code, so the plugin accepts a depth cap, a
+    # per-function instruction-growth cap (percent over the original count),
+    # and loop-nest awareness that lowers the rewrite depth inside nested
+    # loops. None leaves the plugin default; like function targeting, a
+    # plugin build without the flags degrades gracefully.
+    mba_max_depth: Optional[int] = None
+    mba_growth_cap_percent: Optional[int] = None
+    mba_loop_aware: bool = False
 
     def enabled_passes(self) -> List[str]:
         mapping = {
@@ -60,6 +85,51 @@ class SymbolObfuscationConfiguration:
     salt: Optional[str] = None
     preserve_main: bool = True
     preserve_stdlib: bool = True
+    # Project-level symbol table (path to a JSON file): per-TU maps are merged
+    # into it without re-hashing and hashing parameters are verified against
+    # it, guaranteeing link-consistent renaming across translation units.
+    project_map: Optional[str] = None
+
+
+@dataclass
+class StringEncryptionConfiguration:
+    enabled: bool = False
+    # "heap": malloc-based _xor_decrypt helper (works for C and C++)
+    # "arena": single static arena sized at transform time; decrypted strings
+    #          are bump-allocated into it, one allocation instead of one per
+    #          string (works for C and C++)
+    # "constexpr": C++14 template/constexpr literals decrypted into static
+    #              fixed-size buffers with zero heap traffic (C++ only)
+    mode: str = "heap"
+    # Lazy: const globals decrypt on first access through a generated accessor
+    # with a per-string once-flag instead of eagerly in a static constructor.
+    # Decryption cost becomes proportional to strings actually used.
+    # (constexpr mode is already lazy by construction, so this is a no-op there.)
+    lazy: bool = False
+    # SIMD: emit a vectorized XOR kernel (AVX2/SSE2 on x86-64, NEON on arm64,
+    # scalar fallback guarded by preprocessor checks) processing 16/32 bytes
+    # per iteration. Pays off on multi-kilobyte encrypted payloads.
+    simd: bool = False
+    # Packed table: emit one contiguous .rodata blob plus an offset/length/key
+    # index table instead of a per-call-site compound literal. Cuts binary
+    # bloat and relocation work; call sites reference entries by index.
+    # (Not applicable to constexpr mode, which keeps per-literal arrays.)
+    packed_table: bool = False
+    # Dedup: identical literals are interned into one encrypted entry (same
+    # key and ciphertext), and with packed_table one shared table slot, so
+    # "ERROR" appearing 40 times is stored and decrypted once, not 40 times.
+    deduplicate: bool = True
+
+
+@dataclass
+class ProfileGuidedConfiguration:
+    # Shell-style command used to exercise the instrumented binary; "{binary}"
+    # is replaced with its path, otherwise the path is appended. No workload
+    # means profile-guided planning is skipped even at the adaptive level.
+    workload: Optional[str] = None
+    # Maximum acceptable runtime overhead from obfuscation, in percent. Hot
+    # functions are excluded from the passes until the prediction fits.
+    overhead_budget_percent: float = 2.0
 
 
 @dataclass
@@ -67,7 +137,13 @@ class AdvancedConfiguration:
     cycles: int = 1
     string_encryption: bool = False
     fake_loops: int = 0
+    # Time the baseline against the decoy-carrying output and warn when the
+    # added runtime exceeds the threshold. Off by default because it executes
+    # the compiled binaries on the build host.
+    verify_decoy_overhead: bool = False
+    decoy_overhead_threshold_percent: float = 1.0
     symbol_obfuscation: SymbolObfuscationConfiguration = field(default_factory=SymbolObfuscationConfiguration)
+    string_encryption_config: StringEncryptionConfiguration = field(default_factory=StringEncryptionConfiguration)
 
 
 @dataclass
@@ -85,6 +161,15 @@ class ObfuscationConfig:
     advanced: AdvancedConfiguration = field(default_factory=AdvancedConfiguration)
     output: OutputConfiguration = field(default_factory=lambda: OutputConfiguration(Path("./obfuscated")))
     custom_pass_plugin: Optional[Path] = None
+    # Content-addressed compilation cache: identical (source, passes, platform,
+    # toolchain) tuples skip clang entirely. Disable with --no-cache.
+    enable_cache: bool = True
+    # Profiling mode: time every pipeline stage (frontend parse, opt passes
+    # via -time-passes, string/symbol transforms, link) and record the timing
+    # tree in the report.
+    profile: bool = False
+    # Workload and budget for ObfuscationLevel.ADAPTIVE; ignored otherwise.
+    profile_guided: ProfileGuidedConfiguration = field(default_factory=ProfileGuidedConfiguration)
 
     @classmethod
     def from_dict(cls, data: Dict) -> "ObfuscationConfig":
@@ -98,12 +183,29 @@ class ObfuscationConfig:
             bogus_control_flow=passes_data.get("bogus_control_flow", False),
             split=passes_data.get("split", False),
             linear_mba=passes_data.get("linear_mba", False),
+            skip_functions=list(passes_data.get("skip_functions", []) or []),
+            only_functions=list(passes_data.get("only_functions", []) or []),
+            mba_max_depth=passes_data.get("mba_max_depth"),
+            mba_growth_cap_percent=passes_data.get("mba_growth_cap_percent"),
+            mba_loop_aware=passes_data.get("mba_loop_aware", False),
         )
         adv_data = data.get("advanced", {})
+        string_enc_data = adv_data.get("string_encryption_config", {})
+        string_enc_config = StringEncryptionConfiguration(
+            enabled=adv_data.get("string_encryption", False),
+            mode=string_enc_data.get("mode", "heap"),
+            lazy=string_enc_data.get("lazy", False),
+            simd=string_enc_data.get("simd", False),
+            packed_table=string_enc_data.get("packed_table", False),
+            deduplicate=string_enc_data.get("deduplicate", True),
+        )
         advanced = AdvancedConfiguration(
             cycles=adv_data.get("cycles", 1),
             string_encryption=adv_data.get("string_encryption", False),
             fake_loops=adv_data.get("fake_loops", 0),
+            verify_decoy_overhead=adv_data.get("verify_decoy_overhead", False),
+            decoy_overhead_threshold_percent=adv_data.get("decoy_overhead_threshold_percent", 1.0),
+            string_encryption_config=string_enc_config,
         )
         output_data = data.get("output", {})
         output = OutputConfiguration(
@@ -113,6 +215,13 @@ class ObfuscationConfig:
         custom_pass_plugin = data.get("custom_pass_plugin")
         if custom_pass_plugin:
             custom_pass_plugin = Path(custom_pass_plugin)
+        enable_cache = data.get("cache", True)
+        profile = data.get("profile", False)
+        pg_data = data.get("profile_guided", {})
+        profile_guided = ProfileGuidedConfiguration(
+            workload=pg_data.get("workload"),
+            overhead_budget_percent=pg_data.get("overhead_budget_percent", 2.0),
+        )
         return cls(
             level=level,
             platform=platform,
@@ -121,6 +230,9 @@ class ObfuscationConfig:
             advanced=advanced,
             output=output,
             custom_pass_plugin=custom_pass_plugin,
+            enable_cache=enable_cache,
+            profile=profile,
+            profile_guided=profile_guided,
         )
 
 
@@ -1,8 +1,30 @@
+"""
+Decoy code generation guarded by opaque predicates.
+
+The original generator emitted loops with live `volatile int sink` bodies;
+executed from a hot function they burn real cycles, which kept the feature
+off in production. Decoys are now wrapped in functions whose bodies sit
+behind predicates that are algebraically false for every input (x*(x+1) is
+always even, squares are never 2 mod 4 or 2 mod 3, 7y^2-1 is never a square)
+but read their operands from volatile anchors, so the optimizer can neither
+fold the branch away nor prove the body dead. The decoy code lands in the
+binary; the guarded body never executes and the branch predictor learns to
+skip it, so the runtime cost is the predicate evaluation alone.
+
+verify_decoy_overhead() measures that claim: it times the baseline and the
+decoy-carrying binary and reports whether the added runtime stays below a
+threshold.
+"""
+
 from __future__ import annotations
 
 import random
+import statistics
+import subprocess
+import time
 from dataclasses import dataclass
-from typing import List
+from pathlib import Path
+from typing import Dict, List
 
 
 @dataclass
@@ -10,10 +32,23 @@ class FakeLoop:
     loop_type: str
     location: str
     code_snippet: str
+    # Human-readable form of the always-false guard in front of the body.
+    predicate: str = ""
+
+
+# (condition template, description). Each condition is false for every value
+# of the volatile anchors x and y, but proving that requires number theory
+# the optimizer does not do.
+_OPAQUE_PREDICATES = [
+    ("((x * (x + 1u)) & 1u) == 1u", "x*(x+1) is always even"),
+    ("((x * x) & 3u) == 2u", "a square is never 2 mod 4"),
+    ("((x * x) % 3u) == 2u", "a square is never 2 mod 3"),
+    ("(7u * y * y - 1u) == (x * x)", "7y^2-1 is never a square (mod 8)"),
+]
 
 
 class FakeLoopGenerator:
-    """Generates non-functional loops for obfuscation reports (stub implementation)."""
+    """Generates never-executed decoy loops guarded by opaque predicates."""
 
     def __init__(self, seed: int = 42) -> None:
         self._rand = random.Random(seed)
@@ -23,28 +58,93 @@ class FakeLoopGenerator:
         for index in range(count):
             loop_type = self._rand.choice(["while", "for", "do-while"])
             values = [self._rand.randint(1, 100) for _ in range(4)]
+            condition, description = self._rand.choice(_OPAQUE_PREDICATES)
             if loop_type == "while":
                 modulus = max(1, values[3])
-                snippet = (
-                    f"int counter_{index} = {values[0]};\n"
-                    f"while(counter_{index} < {values[1]}) {{\n"
-                    f"    counter_{index} += {values[2]};\n"
-                    f"    if((counter_{index} % {modulus}) == 0) {{ break; }}\n"
-                    "}"
+                body = (
+                    f"        int counter_{index} = {values[0]};\n"
+                    f"        while (counter_{index} < {values[1]} * (int)x) {{\n"
+                    f"            counter_{index} += {values[2]};\n"
+                    f"            if ((counter_{index} % {modulus}) == 0) {{ break; }}\n"
+                    "        }\n"
+                    f"        __obf_anchor_{index} = (unsigned int)counter_{index};"
                 )
             elif loop_type == "for":
-                snippet = (
-                    f"for(int i_{index} = {values[0]}; i_{index} < {values[1]}; ++i_{index}) {{\n"
-                    f"    volatile int sink_{index} = i_{index} * {values[2]};\n"
-                    "}"
+                body = (
+                    f"        for (int i_{index} = {values[0]}; i_{index} < {values[1]} * (int)x; ++i_{index}) {{\n"
+                    f"            __obf_anchor_{index} += (unsigned int)(i_{index} * {values[2]});\n"
+                    "        }"
                 )
             else:  # do-while
-                snippet = (
-                    f"int dummy_{index} = {values[0]};\n"
-                    "do {\n"
-                    f"    dummy_{index} += {values[1]};\n"
-                    f"}} while(dummy_{index} < {values[2]});"
+                body = (
+                    f"        int dummy_{index} = {values[0]};\n"
+                    "        do {\n"
+                    f"            dummy_{index} += {values[1]} + (int)y;\n"
+                    f"        }} while (dummy_{index} < {values[2]} * (int)x);\n"
+                    f"        __obf_anchor_{index} = (unsigned int)dummy_{index};"
                 )
+            snippet = (
+                f"static volatile unsigned int __obf_anchor_{index} = {values[0]}u;\n"
+                f"__attribute__((used)) static void __obf_decoy_{index}(void) {{\n"
+                f"    unsigned int x = __obf_anchor_{index};\n"
+                f"    unsigned int y = x ^ {values[1]}u;\n"
+                f"    (void)y;\n"
+                f"    /* {description}: the body below never executes */\n"
+                f"    if ({condition}) {{\n"
+                f"{body}\n"
+                "    }\n"
+                "}"
+            )
             location = f"{filename}:fake_loop_{index}"
-            loops.append(FakeLoop(loop_type=loop_type, location=location, code_snippet=snippet))
+            loops.append(FakeLoop(
+                loop_type=loop_type,
+                location=location,
+                code_snippet=snippet,
+                predicate=description,
+            ))
         return loops
+
+    @staticmethod
+    def emit_source(loops: List[FakeLoop]) -> str:
+        """Render the decoys as a C fragment appended to the working source."""
+        if not loops:
+            return ""
+        blocks = "\n\n".join(loop.code_snippet for loop in loops)
+        return f"\n/* --- obfuscation decoys (never executed) --- */\n{blocks}\n"
+
+
+def verify_decoy_overhead(
+    reference_binary: Path,
+    candidate_binary: Path,
+    threshold_percent: float = 1.0,
+    warmup: int = 1,
+    repetitions: int = 5,
+    timeout: int = 120,
+) -> Dict:
+    """Confirm the decoy-carrying binary is not measurably slower.
+
+    Both binaries are timed with warmup and a median over repetitions, the
+    same discipline as the benchmark suite; the result records the medians,
+    the relative overhead, and whether it stays under the threshold.
+    """
+    def median_ms(binary: Path) -> float:
+        for _ in range(warmup):
+            subprocess.run([str(binary)], capture_output=True, timeout=timeout)
+        samples: List[float] = []
+        for _ in range(repetitions):
+            started = time.perf_counter()
+            subprocess.run([str(binary)], capture_output=True, timeout=timeout)
+            samples.append((time.perf_counter() - started) * 1000)
+        return statistics.median(samples)
+
+    reference_ms = median_ms(reference_binary)
+    candidate_ms = median_ms(candidate_binary)
+    overhead = (candidate_ms - reference_ms) / reference_ms * 100 if reference_ms > 0 else 0.0
+    return {
+        "reference_ms": round(reference_ms, 3),
+        "candidate_ms": round(candidate_ms, 3),
+        "overhead_percent": round(overhead, 2),
+        "threshold_percent": threshold_percent,
+        "within_threshold": overhead <= threshold_percent,
+        "repetitions": repetitions,
+    }
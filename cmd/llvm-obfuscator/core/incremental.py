@@ -0,0 +1,132 @@
+from __future__ import annotations
+
+import json
+import time
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+from .batch import BatchJobResult, BatchObfuscator, BatchSummary
+from .cache import CompilationCache
+from .config import ObfuscationConfig
+from .utils import create_logger, ensure_directory
+
+DEFAULT_STATE_FILE = Path("./.obf-incremental.json")
+
+
+class IncrementalObfuscator:
+    """Change-driven re-obfuscation for multi-file projects.
+
+    Records a manifest of per-TU input keys (source text plus every
+    ObfuscationConfig knob that affects output, as hashed by
+    CompilationCache.compute_key) alongside the path of the obfuscated
+    artifact each TU produced. On the next run, TUs whose key is unchanged
+    are satisfied from the manifest — restoring the artifact from the
+    compilation cache if it was deleted — and only changed TUs go through
+    the batch engine. On a tree where a handful of files changed, the run
+    cost is a hash pass plus the rebuilds, not a full obfuscation pass.
+    """
+
+    def __init__(
+        self,
+        workers: Optional[int] = None,
+        fail_fast: bool = False,
+        report_dir: Path = Path("./reports"),
+        state_file: Path = DEFAULT_STATE_FILE,
+    ) -> None:
+        self.logger = create_logger(__name__)
+        self.engine = BatchObfuscator(workers=workers, fail_fast=fail_fast, report_dir=report_dir)
+        self.cache = CompilationCache()
+        self.state_file = state_file
+
+    def run(self, jobs: List[Dict]) -> BatchSummary:
+        started = time.time()
+        state = self._load_state()
+        reused: List[BatchJobResult] = []
+        to_build: List[Tuple[Dict, str]] = []
+
+        for job in jobs:
+            key = self._job_key(job)
+            if key is None:
+                to_build.append((job, ""))
+                continue
+            result = self._try_reuse(job, key, state)
+            if result:
+                reused.append(result)
+            else:
+                to_build.append((job, key))
+
+        if reused:
+            self.logger.info(
+                "Incremental: %d/%d TUs unchanged, rebuilding %d",
+                len(reused), len(jobs), len(to_build),
+            )
+
+        if to_build:
+            summary = self.engine.run([job for job, _ in to_build])
+        else:
+            summary = BatchSummary(0, 0, 0, 0, 0.0)
+
+        self._update_state(state, summary.results, to_build)
+        summary.total = len(jobs)
+        summary.reused = len(reused)
+        summary.results = reused + summary.results
+        summary.wall_time_seconds = time.time() - started
+        return summary
+
+    # Internal --------------------------------------------------------------
+
+    def _job_key(self, job: Dict) -> Optional[str]:
+        source: Path = job["source"]
+        config: ObfuscationConfig = job["config"]
+        try:
+            source_text = source.read_text(encoding="utf-8", errors="replace")
+        except OSError:
+            return None
+        return self.cache.compute_key(source_text, config)
+
+    def _try_reuse(self, job: Dict, key: str, state: Dict[str, Dict]) -> Optional[BatchJobResult]:
+        entry = state.get(str(job["source"]))
+        if not entry or entry.get("key") != key or not entry.get("output_file"):
+            return None
+        output_file = Path(entry["output_file"])
+        if not output_file.exists() and not self.cache.restore_binary(key, output_file):
+            # Artifact gone and not recoverable from the cache; rebuild.
+            return None
+        return BatchJobResult(
+            source=job["source"],
+            status="reused",
+            result={"output_file": str(output_file), "incremental": True},
+        )
+
+    def _load_state(self) -> Dict[str, Dict]:
+        if not self.state_file.exists():
+            return {}
+        try:
+            with self.state_file.open("r", encoding="utf-8") as f:
+                data = json.load(f)
+            return data.get("translation_units", {})
+        except (json.JSONDecodeError, OSError):
+            self.logger.warning("Incremental state unreadable, rebuilding everything")
+            return {}
+
+    def _update_state(
+        self,
+        state: Dict[str, Dict],
+        results: List[BatchJobResult],
+        built: List[Tuple[Dict, str]],
+    ) -> None:
+        keys = {str(job["source"]): key for job, key in built if key}
+        for result in results:
+            source = str(result.source)
+            if result.status == "succeeded" and result.result and source in keys:
+                state[source] = {
+                    "key": keys[source],
+                    "output_file": result.result.get("output_file"),
+                    "built_at": time.time(),
+                }
+            elif result.status == "failed":
+                # Drop stale entries so the TU is retried next run.
+                state.pop(source, None)
+        ensure_directory(self.state_file.parent)
+        with self.state_file.open("w", encoding="utf-8") as f:
+            json.dump({"version": 1, "translation_units": state}, f, indent=2)
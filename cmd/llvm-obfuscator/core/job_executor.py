@@ -0,0 +1,147 @@
+from __future__ import annotations
+
+import os
+import queue
+import resource
+import threading
+import time
+from dataclasses import dataclass, field
+from typing import Callable, Dict, Optional
+
+from .utils import create_logger
+
+# Same env-style knobs as the other service flags (OBFUSCATOR_API_KEY etc.).
+DEFAULT_WORKERS = int(os.environ.get("OBFUSCATOR_WORKERS", "2"))
+DEFAULT_QUEUE_DEPTH = int(os.environ.get("OBFUSCATOR_QUEUE_DEPTH", "16"))
+
+
+class QueueFullError(Exception):
+    """Raised when the job queue is at capacity; callers should back off."""
+
+
+@dataclass(order=True)
+class _QueuedJob:
+    priority: int
+    enqueued_at: float
+    job_id: str = field(compare=False)
+    fn: Callable[..., None] = field(compare=False)
+    args: tuple = field(compare=False)
+
+
+class JobExecutor:
+    """Bounded worker pool with a priority queue for API obfuscation jobs.
+
+    A fixed number of worker threads (each job still spawns its own clang
+    processes, so N workers bounds concurrent compilations at N) pull from a
+    depth-limited priority queue; equal priorities drain FIFO. submit()
+    raises QueueFullError when the queue is at capacity so the API layer can
+    answer 429 instead of letting a burst of POSTs fork clang twenty times
+    at once. Per-job accounting (queue wait, run duration, process rusage
+    deltas) is handed to an optional callback for JobRecord.metadata.
+    """
+
+    def __init__(
+        self,
+        workers: int = DEFAULT_WORKERS,
+        queue_depth: int = DEFAULT_QUEUE_DEPTH,
+        on_metrics: Optional[Callable[[str, Dict], None]] = None,
+    ) -> None:
+        self.logger = create_logger(__name__)
+        self.workers = max(1, workers)
+        self.queue_depth = max(1, queue_depth)
+        self.on_metrics = on_metrics
+        self._queue: "queue.PriorityQueue[_QueuedJob]" = queue.PriorityQueue(maxsize=self.queue_depth)
+        self._active = 0
+        self._lock = threading.Lock()
+        self._shutdown = threading.Event()
+        self._threads = [
+            threading.Thread(target=self._worker, name=f"obf-worker-{i}", daemon=True)
+            for i in range(self.workers)
+        ]
+        for thread in self._threads:
+            thread.start()
+
+    def submit(self, job_id: str, fn: Callable[..., None], *args, priority: int = 10) -> None:
+        """Queue a job; lower priority values run first. Raises QueueFullError."""
+        item = _QueuedJob(priority=priority, enqueued_at=time.time(), job_id=job_id, fn=fn, args=args)
+        try:
+            self._queue.put_nowait(item)
+        except queue.Full:
+            raise QueueFullError(
+                f"Job queue full ({self.queue_depth} pending); retry later"
+            ) from None
+        self.logger.info("Queued job %s (depth %d/%d)", job_id, self._queue.qsize(), self.queue_depth)
+
+    def stats(self) -> Dict:
+        with self._lock:
+            active = self._active
+        return {
+            "workers": self.workers,
+            "active": active,
+            "queued": self._queue.qsize(),
+            "queue_depth": self.queue_depth,
+        }
+
+    def shutdown(self) -> None:
+        self._shutdown.set()
+        for _ in self._threads:
+            try:
+                self._queue.put_nowait(_QueuedJob(-1, 0.0, "", None, ()))  # wake sentinel
+            except queue.Full:
+                break
+
+    # Internal --------------------------------------------------------------
+
+    def _worker(self) -> None:
+        while not self._shutdown.is_set():
+            item = self._queue.get()
+            if item.fn is None:  # shutdown sentinel
+                self._queue.task_done()
+                break
+            with self._lock:
+                self._active += 1
+            started = time.time()
+            usage_before = self._usage_snapshot()
+            try:
+                item.fn(*item.args)
+            except Exception:  # job fns record their own failures; don't kill the worker
+                self.logger.exception("Job %s raised out of its handler", item.job_id)
+            finally:
+                finished = time.time()
+                usage_after = self._usage_snapshot()
+                with self._lock:
+                    self._active -= 1
+                self._queue.task_done()
+                self._report_metrics(item, started, finished, usage_before, usage_after)
+
+    @staticmethod
+    def _usage_snapshot() -> Dict[str, float]:
+        own = resource.getrusage(resource.RUSAGE_SELF)
+        children = resource.getrusage(resource.RUSAGE_CHILDREN)
+        return {
+            "utime": own.ru_utime + children.ru_utime,
+            "stime": own.ru_stime + children.ru_stime,
+            "maxrss": max(own.ru_maxrss, children.ru_maxrss),
+        }
+
+    def _report_metrics(
+        self, item: _QueuedJob, started: float, finished: float,
+        before: Dict[str, float], after: Dict[str, float],
+    ) -> None:
+        if not self.on_metrics:
+            return
+        metrics = {
+            "queue_wait_seconds": round(started - item.enqueued_at, 3),
+            "run_seconds": round(finished - started, 3),
+            "worker": threading.current_thread().name,
+            # rusage deltas are process-wide, so numbers are approximate when
+            # jobs overlap; clang runs as child processes, which the CHILDREN
+            # counters capture.
+            "cpu_user_seconds": round(after["utime"] - before["utime"], 3),
+            "cpu_system_seconds": round(after["stime"] - before["stime"], 3),
+            "max_rss_kb": int(after["maxrss"]),
+        }
+        try:
+            self.on_metrics(item.job_id, metrics)
+        except Exception:  # pragma: no cover - defensive
+            self.logger.exception("Metrics callback failed for job %s", item.job_id)
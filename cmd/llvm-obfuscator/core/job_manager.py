@@ -1,11 +1,20 @@
 from __future__ import annotations
 
+import json
+import os
+import sqlite3
 import uuid
 from dataclasses import dataclass, field
 from datetime import datetime
+from pathlib import Path
 from typing import Dict, List, Optional
 
 from .exceptions import JobNotFoundError
+from .utils import ensure_directory
+
+DEFAULT_DB_PATH = Path(os.environ.get("OBFUSCATOR_JOB_DB", "./jobs.db"))
+# Jobs older than this are purged; 0 disables expiry.
+DEFAULT_JOB_TTL_SECONDS = int(os.environ.get("OBFUSCATOR_JOB_TTL_SECONDS", str(7 * 24 * 3600)))
 
 
 @dataclass
@@ -19,12 +28,38 @@ class JobRecord:
 
 
 class JobManager:
-    """In-memory job registry (non-persistent)."""
+    """SQLite-backed job registry.
+
+    Jobs survive restarts, lookups by job_id and status are indexed, and
+    list_jobs() paginates instead of returning the full table. Records past
+    the TTL are purged opportunistically so the table and response times
+    stay flat as job count grows. One connection is opened per operation,
+    which keeps the manager safe to call from the API event loop and the
+    executor worker threads alike.
+    """
 
-    def __init__(self) -> None:
-        self._jobs: Dict[str, JobRecord] = {}
+    _SCHEMA = """
+    CREATE TABLE IF NOT EXISTS jobs (
+        job_id TEXT PRIMARY KEY,
+        status TEXT NOT NULL,
+        created_at TEXT NOT NULL,
+        updated_at TEXT NOT NULL,
+        metadata TEXT NOT NULL DEFAULT '{}',
+        report_paths TEXT NOT NULL DEFAULT '{}'
+    );
+    CREATE INDEX IF NOT EXISTS idx_jobs_status ON jobs(status);
+    CREATE INDEX IF NOT EXISTS idx_jobs_created_at ON jobs(created_at);
+    """
+
+    def __init__(self, db_path: Path = DEFAULT_DB_PATH, ttl_seconds: int = DEFAULT_JOB_TTL_SECONDS) -> None:
+        self.db_path = Path(db_path)
+        self.ttl_seconds = ttl_seconds
+        ensure_directory(self.db_path.parent)
+        with self._connect() as conn:
+            conn.executescript(self._SCHEMA)
 
     def create_job(self, metadata: Dict) -> JobRecord:
+        self.purge_expired()
         job_id = uuid.uuid4().hex
         now = datetime.utcnow()
         record = JobRecord(
@@ -34,32 +69,120 @@ class JobManager:
             updated_at=now,
             metadata=metadata,
         )
-        self._jobs[job_id] = record
+        with self._connect() as conn:
+            conn.execute(
+                "INSERT INTO jobs (job_id, status, created_at, updated_at, metadata, report_paths)"
+                " VALUES (?, ?, ?, ?, ?, ?)",
+                (
+                    job_id,
+                    record.status,
+                    now.isoformat(),
+                    now.isoformat(),
+                    json.dumps(metadata, default=str),
+                    "{}",
+                ),
+            )
         return record
 
     def update_job(self, job_id: str, status: Optional[str] = None, **metadata: Dict) -> JobRecord:
-        record = self._jobs.get(job_id)
-        if not record:
-            raise JobNotFoundError(job_id)
-        if status:
-            record.status = status
-        if metadata:
-            record.metadata.update(metadata)
-        record.updated_at = datetime.utcnow()
+        with self._connect() as conn:
+            row = conn.execute("SELECT * FROM jobs WHERE job_id = ?", (job_id,)).fetchone()
+            if not row:
+                raise JobNotFoundError(job_id)
+            record = self._row_to_record(row)
+            if status:
+                record.status = status
+            if metadata:
+                record.metadata.update(metadata)
+            record.updated_at = datetime.utcnow()
+            conn.execute(
+                "UPDATE jobs SET status = ?, updated_at = ?, metadata = ? WHERE job_id = ?",
+                (
+                    record.status,
+                    record.updated_at.isoformat(),
+                    json.dumps(record.metadata, default=str),
+                    job_id,
+                ),
+            )
         return record
 
     def attach_reports(self, job_id: str, reports: Dict[str, str]) -> JobRecord:
-        record = self._jobs.get(job_id)
-        if not record:
-            raise JobNotFoundError(job_id)
-        record.report_paths.update(reports)
-        record.updated_at = datetime.utcnow()
+        with self._connect() as conn:
+            row = conn.execute("SELECT * FROM jobs WHERE job_id = ?", (job_id,)).fetchone()
+            if not row:
+                raise JobNotFoundError(job_id)
+            record = self._row_to_record(row)
+            record.report_paths.update({fmt: str(path) for fmt, path in reports.items()})
+            record.updated_at = datetime.utcnow()
+            conn.execute(
+                "UPDATE jobs SET updated_at = ?, report_paths = ? WHERE job_id = ?",
+                (
+                    record.updated_at.isoformat(),
+                    json.dumps(record.report_paths, default=str),
+                    job_id,
+                ),
+            )
         return record
 
     def get_job(self, job_id: str) -> JobRecord:
-        if job_id not in self._jobs:
+        with self._connect() as conn:
+            row = conn.execute("SELECT * FROM jobs WHERE job_id = ?", (job_id,)).fetchone()
+        if not row:
             raise JobNotFoundError(job_id)
-        return self._jobs[job_id]
+        return self._row_to_record(row)
+
+    def list_jobs(
+        self,
+        status: Optional[str] = None,
+        limit: int = 100,
+        offset: int = 0,
+    ) -> List[JobRecord]:
+        self.purge_expired()
+        query = "SELECT * FROM jobs"
+        params: list = []
+        if status:
+            query += " WHERE status = ?"
+            params.append(status)
+        query += " ORDER BY created_at DESC LIMIT ? OFFSET ?"
+        params.extend([max(0, limit), max(0, offset)])
+        with self._connect() as conn:
+            rows = conn.execute(query, params).fetchall()
+        return [self._row_to_record(row) for row in rows]
+
+    def count_jobs(self, status: Optional[str] = None) -> int:
+        query = "SELECT COUNT(*) FROM jobs"
+        params: list = []
+        if status:
+            query += " WHERE status = ?"
+            params.append(status)
+        with self._connect() as conn:
+            return conn.execute(query, params).fetchone()[0]
+
+    def purge_expired(self) -> int:
+        """Delete jobs older than the TTL; returns the number removed."""
+        if self.ttl_seconds <= 0:
+            return 0
+        cutoff = datetime.utcfromtimestamp(
+            datetime.utcnow().timestamp() - self.ttl_seconds
+        ).isoformat()
+        with self._connect() as conn:
+            cursor = conn.execute("DELETE FROM jobs WHERE created_at < ?", (cutoff,))
+            return cursor.rowcount
 
-    def list_jobs(self) -> List[JobRecord]:
-        return list(self._jobs.values())
+    # Internal --------------------------------------------------------------
+
+    def _connect(self) -> sqlite3.Connection:
+        conn = sqlite3.connect(self.db_path, timeout=30)
+        conn.row_factory = sqlite3.Row
+        return conn
+
+    @staticmethod
+    def _row_to_record(row: sqlite3.Row) -> JobRecord:
+        return JobRecord(
+            job_id=row["job_id"],
+            status=row["status"],
+            created_at=datetime.fromisoformat(row["created_at"]),
+            updated_at=datetime.fromisoformat(row["updated_at"]),
+            metadata=json.loads(row["metadata"]),
+            report_paths=json.loads(row["report_paths"]),
+        )
@@ -0,0 +1,167 @@
+from __future__ import annotations
+
+import json
+import os
+import sqlite3
+from datetime import datetime
+from pathlib import Path
+from typing import Dict, Optional, Tuple
+
+from .utils import create_logger, ensure_directory
+
+# Shared-broker knobs, same env style as the job registry. The queue database
+# lives on storage every node can reach (the same arrangement as
+# OBFUSCATOR_JOB_DB and the report store).
+DEFAULT_QUEUE_DB_PATH = Path(os.environ.get("OBFUSCATOR_QUEUE_DB", "./queue.db"))
+# A claimed job whose lease lapses without a heartbeat is treated as owned by
+# a dead worker and requeued.
+DEFAULT_LEASE_SECONDS = int(os.environ.get("OBFUSCATOR_LEASE_SECONDS", "300"))
+DEFAULT_MAX_ATTEMPTS = int(os.environ.get("OBFUSCATOR_MAX_ATTEMPTS", "3"))
+
+
+class JobQueue:
+    """SQLite-backed work queue shared by the API node and the workers.
+
+    The API enqueues a self-contained payload (source plus config dict);
+    workers claim jobs with a lease, heartbeat while compiling, and either
+    complete or fail them. claim() runs inside an IMMEDIATE transaction so
+    two workers can never own the same job, and expired leases are requeued
+    opportunistically on every claim — a crashed worker costs one lease
+    period, not a lost job. Jobs that exhaust their attempts go to 'dead'
+    instead of cycling forever.
+    """
+
+    _SCHEMA = """
+    CREATE TABLE IF NOT EXISTS queue (
+        job_id TEXT PRIMARY KEY,
+        payload TEXT NOT NULL,
+        state TEXT NOT NULL DEFAULT 'pending',
+        worker_id TEXT,
+        attempts INTEGER NOT NULL DEFAULT 0,
+        last_error TEXT,
+        enqueued_at TEXT NOT NULL,
+        lease_expires_at TEXT
+    );
+    CREATE INDEX IF NOT EXISTS idx_queue_state ON queue(state, enqueued_at);
+    """
+
+    def __init__(
+        self,
+        db_path: Path = DEFAULT_QUEUE_DB_PATH,
+        lease_seconds: int = DEFAULT_LEASE_SECONDS,
+        max_attempts: int = DEFAULT_MAX_ATTEMPTS,
+    ) -> None:
+        self.logger = create_logger(__name__)
+        self.db_path = Path(db_path)
+        self.lease_seconds = lease_seconds
+        self.max_attempts = max_attempts
+        ensure_directory(self.db_path.parent)
+        with self._connect() as conn:
+            conn.executescript(self._SCHEMA)
+
+    def enqueue(self, job_id: str, payload: Dict) -> None:
+        with self._connect() as conn:
+            conn.execute(
+                "INSERT INTO queue (job_id, payload, state, enqueued_at) VALUES (?, ?, 'pending', ?)",
+                (job_id, json.dumps(payload, default=str), self._now()),
+            )
+        self.logger.info("Enqueued job %s", job_id)
+
+    def claim(self, worker_id: str) -> Optional[Tuple[str, Dict]]:
+        """Atomically take ownership of the oldest pending job, if any."""
+        self.requeue_expired()
+        with self._connect() as conn:
+            conn.execute("BEGIN IMMEDIATE")
+            row = conn.execute(
+                "SELECT job_id, payload FROM queue WHERE state = 'pending' ORDER BY enqueued_at LIMIT 1"
+            ).fetchone()
+            if not row:
+                return None
+            cursor = conn.execute(
+                "UPDATE queue SET state = 'claimed', worker_id = ?, attempts = attempts + 1,"
+                " lease_expires_at = ? WHERE job_id = ? AND state = 'pending'",
+                (worker_id, self._lease_deadline(), row["job_id"]),
+            )
+            if cursor.rowcount != 1:  # pragma: no cover - IMMEDIATE lock prevents this
+                return None
+        return row["job_id"], json.loads(row["payload"])
+
+    def heartbeat(self, job_id: str, worker_id: str) -> bool:
+        """Extend the lease; returns False if the job is no longer ours."""
+        with self._connect() as conn:
+            cursor = conn.execute(
+                "UPDATE queue SET lease_expires_at = ? WHERE job_id = ? AND worker_id = ? AND state = 'claimed'",
+                (self._lease_deadline(), job_id, worker_id),
+            )
+            return cursor.rowcount == 1
+
+    def complete(self, job_id: str, worker_id: str) -> None:
+        """Drop the finished job; the registry and report store keep the record."""
+        with self._connect() as conn:
+            conn.execute(
+                "DELETE FROM queue WHERE job_id = ? AND worker_id = ?",
+                (job_id, worker_id),
+            )
+
+    def fail(self, job_id: str, worker_id: str, error: str) -> bool:
+        """Record a failure; returns True when the job was requeued for retry."""
+        with self._connect() as conn:
+            row = conn.execute(
+                "SELECT attempts FROM queue WHERE job_id = ? AND worker_id = ?",
+                (job_id, worker_id),
+            ).fetchone()
+            if not row:
+                return False
+            retry = row["attempts"] < self.max_attempts
+            conn.execute(
+                "UPDATE queue SET state = ?, worker_id = NULL, lease_expires_at = NULL,"
+                " last_error = ? WHERE job_id = ?",
+                ("pending" if retry else "dead", error, job_id),
+            )
+        return retry
+
+    def requeue_expired(self) -> int:
+        """Return jobs whose worker stopped heartbeating to the pending pool."""
+        now = self._now()
+        with self._connect() as conn:
+            requeued = conn.execute(
+                "UPDATE queue SET state = 'pending', worker_id = NULL, lease_expires_at = NULL,"
+                " last_error = 'worker lease expired'"
+                " WHERE state = 'claimed' AND lease_expires_at < ? AND attempts < ?",
+                (now, self.max_attempts),
+            ).rowcount
+            conn.execute(
+                "UPDATE queue SET state = 'dead', worker_id = NULL,"
+                " last_error = 'worker lease expired'"
+                " WHERE state = 'claimed' AND lease_expires_at < ? AND attempts >= ?",
+                (now, self.max_attempts),
+            )
+        if requeued:
+            self.logger.warning("Requeued %d jobs from expired leases", requeued)
+        return requeued
+
+    def stats(self) -> Dict:
+        with self._connect() as conn:
+            rows = conn.execute("SELECT state, COUNT(*) AS n FROM queue GROUP BY state").fetchall()
+        counts = {row["state"]: row["n"] for row in rows}
+        return {
+            "pending": counts.get("pending", 0),
+            "claimed": counts.get("claimed", 0),
+            "dead": counts.get("dead", 0),
+        }
+
+    # Internal --------------------------------------------------------------
+
+    def _connect(self) -> sqlite3.Connection:
+        conn = sqlite3.connect(self.db_path, timeout=30)
+        conn.row_factory = sqlite3.Row
+        return conn
+
+    @staticmethod
+    def _now() -> str:
+        return datetime.utcnow().isoformat()
+
+    def _lease_deadline(self) -> str:
+        return datetime.utcfromtimestamp(
+            datetime.utcnow().timestamp() + self.lease_seconds
+        ).isoformat()
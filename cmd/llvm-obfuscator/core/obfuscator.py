@@ -1,15 +1,26 @@
 from __future__ import annotations
 
 import logging
+import re
+import shutil
+import time
+from concurrent.futures import ThreadPoolExecutor, as_completed
+from dataclasses import replace
 from pathlib import Path
-from typing import Dict, List, Optional
+from typing import Callable, Dict, List, Optional
 
-from .config import ObfuscationConfig, Platform
+from .cache import CompilationCache
+from .config import ObfuscationConfig, ObfuscationLevel, OutputConfiguration, Platform
 from .exceptions import ObfuscationError
-from .fake_loop_inserter import FakeLoopGenerator
+from .fake_loop_inserter import FakeLoopGenerator, verify_decoy_overhead
+from .profile_guide import ProfileGuidedPlanner
+from .profiler import PipelineProfiler, maybe_stage
+from .progress import ProgressEvent
 from .reporter import ObfuscationReport
 from .string_encryptor import StringEncryptionResult, XORStringEncryptor
+from .symbol_cache import ProjectSymbolCache
 from .symbol_obfuscator import SymbolObfuscator
+from .toolchain import get_toolchain
 from .utils import (
     compute_entropy,
     create_logger,
@@ -46,15 +57,65 @@ class LLVMObfuscator:
         "split",
     ]
 
-    def __init__(self, reporter: Optional[ObfuscationReport] = None) -> None:
+    def __init__(
+        self,
+        reporter: Optional[ObfuscationReport] = None,
+        progress_callback: Optional[Callable[[ProgressEvent], None]] = None,
+    ) -> None:
         self.logger = create_logger(__name__)
         self.reporter = reporter
+        self.progress_callback = progress_callback
         self.encryptor = XORStringEncryptor()
         self.fake_loop_generator = FakeLoopGenerator()
         self.symbol_obfuscator = SymbolObfuscator()
+        self.cache = CompilationCache()
+        # Shared, fingerprint-validated toolchain probe cache: plugin paths,
+        # resource-dir flags, and tool checks are resolved once per toolchain
+        # state instead of once per job.
+        self.toolchain = get_toolchain()
+
+    def _publish(
+        self,
+        job_id: Optional[str],
+        stage: str,
+        progress: float,
+        message: str,
+        pass_name: Optional[str] = None,
+        started: Optional[float] = None,
+    ) -> None:
+        """Emit a fine-grained progress event if a callback is wired up."""
+        if not self.progress_callback or not job_id:
+            return
+        elapsed = round(time.time() - started, 3) if started is not None else None
+        try:
+            self.progress_callback(ProgressEvent(
+                job_id=job_id,
+                stage=stage,
+                progress=progress,
+                message=message,
+                pass_name=pass_name,
+                elapsed_seconds=elapsed,
+            ))
+        except Exception:  # pragma: no cover - progress must never kill a job
+            self.logger.exception("Progress callback failed for job %s", job_id)
 
     def _get_bundled_plugin_path(self, target_platform: Optional[Platform] = None) -> Optional[Path]:
-        """Auto-detect bundled OLLVM plugin for current or target platform."""
+        """Auto-detect bundled OLLVM plugin for current or target platform.
+
+        The probe result is cached in the shared toolchain resolver and
+        revalidated against the plugin file's mtime/size, so repeat jobs skip
+        the filesystem walk.
+        """
+        key = f"plugin:{target_platform.value if target_platform else 'auto'}"
+
+        def _probe() -> Optional[str]:
+            path = self._probe_bundled_plugin_path(target_platform)
+            return str(path) if path else None
+
+        cached = self.toolchain.cached_path(key, _probe)
+        return Path(cached) if cached else None
+
+    def _probe_bundled_plugin_path(self, target_platform: Optional[Platform] = None) -> Optional[Path]:
         try:
             import platform
             import os
@@ -131,75 +192,86 @@ class LLVMObfuscator:
         warnings_log = []
         actually_applied_passes = []
 
-        require_tool("clang")
-        if config.platform == Platform.WINDOWS:
-            require_tool("x86_64-w64-mingw32-gcc")
-
         source_content = source_file.read_text(encoding="utf-8", errors="ignore")
 
+        # Profiling wants real timings, so it bypasses the compilation cache.
+        profiler = PipelineProfiler() if config.profile else None
+
+        # Cache check before any toolchain work: a hit skips clang entirely.
+        # Adaptive runs bypass the cache: their pass targeting comes from a
+        # fresh workload profile, not from the config alone.
+        cache_key = None
+        if config.enable_cache and not config.profile and config.level != ObfuscationLevel.ADAPTIVE:
+            cache_key = self.cache.compute_key(source_content, config)
+            cached = self.cache.lookup(cache_key)
+            if cached and self.cache.restore_binary(cache_key, output_binary):
+                self.logger.info("Compilation cache hit (%s), skipping compilation", cache_key[:12])
+                job_data = dict(cached["job_data"])
+                job_data["job_id"] = job_id
+                job_data["timestamp"] = get_timestamp()
+                job_data["output_file"] = str(output_binary)
+                job_data["cache"] = {"hit": True, "key": cache_key}
+                if self.reporter:
+                    report = self.reporter.generate_report(job_data)
+                    exported = self.reporter.export(report, job_id or output_binary.stem, config.output.report_formats)
+                    job_data["report_paths"] = {fmt: str(path) for fmt, path in exported.items()}
+                return job_data
+
+        self.toolchain.require("clang", lambda: require_tool("clang"))
+        if config.platform == Platform.WINDOWS:
+            self.toolchain.require("x86_64-w64-mingw32-gcc", lambda: require_tool("x86_64-w64-mingw32-gcc"))
+
         # Compile baseline (unobfuscated) binary for comparison
         self.logger.info("Compiling baseline binary for comparison...")
+        stage_started = time.time()
+        self._publish(job_id, "baseline", 0.05, "Compiling baseline binary")
         baseline_binary = output_directory / f"{source_file.stem}_baseline"
-        baseline_metrics = self._compile_and_analyze_baseline(source_file, baseline_binary, config)
-
-        # Symbol obfuscation (if enabled) - applied FIRST before other transformations
-        symbol_result = None
-        working_source = source_file
-        if config.advanced.symbol_obfuscation.enabled:
-            try:
-                symbol_obfuscated_file = output_directory / f"{source_file.stem}_symbol_obfuscated{source_file.suffix}"
-                symbol_result = self.symbol_obfuscator.obfuscate(
-                    source_file=source_file,
-                    output_file=symbol_obfuscated_file,
-                    algorithm=config.advanced.symbol_obfuscation.algorithm,
-                    hash_length=config.advanced.symbol_obfuscation.hash_length,
-                    prefix_style=config.advanced.symbol_obfuscation.prefix_style,
-                    salt=config.advanced.symbol_obfuscation.salt,
-                    preserve_main=config.advanced.symbol_obfuscation.preserve_main,
-                    preserve_stdlib=config.advanced.symbol_obfuscation.preserve_stdlib,
-                    generate_map=True,
-                    map_file=output_directory / "symbol_map.json",
-                    is_cpp=source_file.suffix in [".cpp", ".cc", ".cxx"],
+        with maybe_stage(profiler, "baseline_compile"):
+            baseline_metrics = self._compile_and_analyze_baseline(source_file, baseline_binary, config)
+        self._publish(job_id, "baseline", 0.15, "Baseline binary ready", started=stage_started)
+
+        # Adaptive level: profile a workload against an instrumented build and
+        # pull the hottest functions out of the passes to meet the overhead
+        # budget. The plan lands in skip_functions, so the rest of the
+        # pipeline needs no special casing.
+        profile_plan = None
+        if config.level == ObfuscationLevel.ADAPTIVE:
+            stage_started = time.time()
+            self._publish(job_id, "profile_plan", 0.16, "Profiling workload for adaptive planning")
+            with maybe_stage(profiler, "profile_guided_plan"):
+                profile_plan = ProfileGuidedPlanner().plan(source_file, config, output_directory)
+            if profile_plan:
+                merged = list(config.passes.skip_functions)
+                merged.extend(name for name in profile_plan["excluded_functions"] if name not in merged)
+                config = replace(config, passes=replace(config.passes, skip_functions=merged))
+            else:
+                warnings_log.append(
+                    "Profile-guided planning unavailable; passes applied to all functions"
                 )
-                working_source = symbol_obfuscated_file
-                self.logger.info(f"Symbol obfuscation complete: {symbol_result['symbols_obfuscated']} symbols renamed")
-            except Exception as e:
-                self.logger.warning(f"Symbol obfuscation failed, continuing without it: {e}")
-
-        # String encryption (if enabled) - applied to source content
-        string_result: Optional[StringEncryptionResult] = None
-        if config.advanced.string_encryption:
-            try:
-                # Get the symbol-obfuscated source if available, otherwise use original
-                current_source_content = working_source.read_text(encoding="utf-8", errors="replace")
-                string_result = self.encryptor.encrypt_strings(current_source_content)
+            self._publish(job_id, "profile_plan", 0.18, "Profile-guided plan ready", started=stage_started)
 
-                # Write the transformed source to a new file
-                string_encrypted_file = output_directory / f"{source_file.stem}_string_encrypted{source_file.suffix}"
-                string_encrypted_file.write_text(string_result.transformed_source, encoding="utf-8", errors="replace")
-                working_source = string_encrypted_file
-                self.logger.info(f"String encryption complete: {string_result.encrypted_strings}/{string_result.total_strings} strings encrypted")
-            except Exception as e:
-                self.logger.error(f"String encryption failed: {e}")
-                string_result = None
+        working_source, symbol_result, string_result = self._apply_source_transforms(
+            source_file, config, output_directory, job_id, profiler
+        )
 
         fake_loops = []
         if config.advanced.fake_loops:
             fake_loops = self.fake_loop_generator.generate(config.advanced.fake_loops, source_file.name)
+            working_source = self._inject_decoys(working_source, fake_loops, output_directory)
 
         enabled_passes = config.passes.enabled_passes()
         compiler_flags = merge_flags(self.BASE_FLAGS, config.compiler_flags)
 
-        # IMPORTANT: Cycles only make sense for source code recompilation
-        # Once we have a binary, we can't feed it back through the compiler
-        # So if OLLVM passes are enabled, limit to 1 cycle
+        # With OLLVM passes enabled, cycles are applied at the IR level: the
+        # frontend parses once to bitcode and _compile re-runs opt over it per
+        # cycle before lowering. Without passes, cycles still mean source
+        # recompilation, so the outer loop handles them.
         effective_cycles = 1 if enabled_passes else config.advanced.cycles
+        ir_cycles = config.advanced.cycles if enabled_passes else 1
         if enabled_passes and config.advanced.cycles > 1:
-            self.logger.warning(
-                "Multiple cycles (%d) requested with OLLVM passes enabled. "
-                "Cycles only apply to source code compilation. "
-                "Running 1 cycle with all OLLVM passes instead.",
-                config.advanced.cycles
+            self.logger.info(
+                "Running %d obfuscation cycles at the IR level (one frontend parse)",
+                config.advanced.cycles,
             )
 
         intermediate_source = working_source  # Use symbol-obfuscated source if enabled
@@ -207,12 +279,28 @@ class LLVMObfuscator:
             self.logger.info("Starting cycle %s/%s", cycle, effective_cycles)
             intermediate_binary = output_binary if cycle == effective_cycles else output_directory / f"{output_binary.stem}_cycle{cycle}{output_binary.suffix}"
 
-            cycle_result = self._compile(
-                intermediate_source,
-                intermediate_binary,
-                config,
-                compiler_flags,
-                enabled_passes,
+            cycle_started = time.time()
+            cycle_progress = 0.4 + 0.45 * (cycle - 1) / effective_cycles
+            self._publish(
+                job_id, "compile", cycle_progress,
+                f"Cycle {cycle}/{effective_cycles} compiling",
+                pass_name=",".join(enabled_passes) or None,
+            )
+            with maybe_stage(profiler, f"compile_cycle_{cycle}"):
+                cycle_result = self._compile(
+                    intermediate_source,
+                    intermediate_binary,
+                    config,
+                    compiler_flags,
+                    enabled_passes,
+                    ir_cycles,
+                    profiler=profiler,
+                )
+            self._publish(
+                job_id, "compile", 0.4 + 0.45 * cycle / effective_cycles,
+                f"Cycle {cycle}/{effective_cycles} done",
+                pass_name=",".join(enabled_passes) or None,
+                started=cycle_started,
             )
 
             # Track what actually happened
@@ -223,6 +311,34 @@ class LLVMObfuscator:
 
             intermediate_source = intermediate_binary
 
+        # Decoy overhead check: the opaque predicates should make the decoys
+        # free at runtime; measure it instead of assuming it. Host-runnable
+        # binaries only, and the comparison includes every enabled transform,
+        # so a clean config (fake loops alone) gives the sharpest answer.
+        decoy_verification = None
+        if (
+            fake_loops
+            and config.advanced.verify_decoy_overhead
+            and config.platform == Platform.LINUX
+            and baseline_binary.exists()
+            and output_binary.exists()
+        ):
+            self.logger.info("Verifying decoy runtime overhead against the baseline binary")
+            with maybe_stage(profiler, "decoy_overhead_verification"):
+                decoy_verification = verify_decoy_overhead(
+                    baseline_binary,
+                    output_binary,
+                    config.advanced.decoy_overhead_threshold_percent,
+                )
+            if not decoy_verification["within_threshold"]:
+                warning_msg = (
+                    f"Decoy overhead {decoy_verification['overhead_percent']}% exceeds the "
+                    f"{config.advanced.decoy_overhead_threshold_percent}% threshold"
+                )
+                self.logger.warning(warning_msg)
+                warnings_log.append(warning_msg)
+
+        self._publish(job_id, "analysis", 0.9, "Analyzing output binary")
         binary_format = detect_binary_format(output_binary)
         file_size = get_file_size(output_binary)
         sections = list_sections(output_binary)
@@ -274,6 +390,7 @@ class LLVMObfuscator:
             "string_obfuscation": base_metrics["string_obfuscation"],
             "fake_loops_inserted": base_metrics["fake_loops_inserted"],
             "symbol_obfuscation": symbol_result or {"enabled": False},
+            "profile_guided": profile_plan or {"enabled": False},
             "obfuscation_score": base_metrics["obfuscation_score"],
             "symbol_reduction": base_metrics["symbol_reduction"],
             "function_reduction": base_metrics["function_reduction"],
@@ -282,15 +399,288 @@ class LLVMObfuscator:
             "estimated_re_effort": base_metrics["estimated_re_effort"],
             "output_file": str(output_binary),
         }
+        if decoy_verification:
+            job_data["fake_loops_inserted"]["overhead_verification"] = decoy_verification
+
+        if profiler:
+            job_data["profiling"] = profiler.to_dict()
+
+        if cache_key:
+            job_data["cache"] = {"hit": False, "key": cache_key}
+            self.cache.store(cache_key, output_binary, job_data)
 
         if self.reporter:
+            self._publish(job_id, "reporting", 0.95, "Generating reports")
             report = self.reporter.generate_report(job_data)
             exported = self.reporter.export(report, job_id or output_binary.stem, config.output.report_formats)
             job_data["report_paths"] = {fmt: str(path) for fmt, path in exported.items()}
         return job_data
 
+    def obfuscate_multi(
+        self,
+        source_file: Path,
+        config: ObfuscationConfig,
+        platforms: List[Platform],
+        job_id: Optional[str] = None,
+    ) -> Dict:
+        """Build one job for several target platforms.
+
+        The platform-independent stages (symbol obfuscation, string
+        encryption) run once; per-platform lowering then runs concurrently -
+        the work is subprocess-bound, so threads are enough. Each platform
+        gets its own subdirectory under the output directory since linux and
+        macos artifacts would otherwise share a name. One failing platform
+        does not abort the others; the job fails only if every target fails.
+        """
+        # Deduplicate while preserving order (darwin aliases macos).
+        targets: List[Platform] = []
+        for platform_target in platforms:
+            normalized = Platform.from_string(platform_target.value)
+            if normalized not in targets:
+                targets.append(normalized)
+        if not targets:
+            raise ObfuscationError("No target platforms given")
+        if len(targets) == 1:
+            return self.obfuscate(source_file, replace(config, platform=targets[0]), job_id)
+
+        if not source_file.exists():
+            raise FileNotFoundError(f"Source file not found: {source_file}")
+
+        output_directory = config.output.directory
+        ensure_directory(output_directory)
+        profiler = PipelineProfiler() if config.profile else None
+
+        # Phase 1: source transforms, once for all targets.
+        working_source, symbol_result, string_result = self._apply_source_transforms(
+            source_file, config, output_directory, job_id, profiler
+        )
+
+        # Re-stage the transformed source under the original filename so the
+        # per-platform artifacts keep the original stem (hello, hello.exe)
+        # instead of hello_string_encrypted.
+        if working_source != source_file:
+            staging_dir = output_directory / "stage"
+            ensure_directory(staging_dir)
+            staged_source = staging_dir / source_file.name
+            shutil.copy2(working_source, staged_source)
+            working_source = staged_source
+
+        # Phase 2: concurrent per-platform lowering. The derived configs
+        # disable the transforms already applied so no target redoes them.
+        def _platform_config(platform_target: Platform) -> ObfuscationConfig:
+            return replace(
+                config,
+                platform=platform_target,
+                output=OutputConfiguration(
+                    directory=output_directory / platform_target.value,
+                    report_formats=list(config.output.report_formats),
+                ),
+                advanced=replace(
+                    config.advanced,
+                    string_encryption=False,
+                    symbol_obfuscation=replace(config.advanced.symbol_obfuscation, enabled=False),
+                ),
+            )
+
+        platform_results: Dict[str, Dict] = {}
+        errors: Dict[str, str] = {}
+        fanout_started = time.time()
+        self._publish(
+            job_id, "platform_build", 0.4,
+            f"Building for {len(targets)} platforms: {', '.join(t.value for t in targets)}",
+        )
+        with maybe_stage(profiler, "platform_fanout"):
+            with ThreadPoolExecutor(max_workers=len(targets)) as pool:
+                futures = {
+                    pool.submit(
+                        # Bare worker per target: no reporter (one aggregate
+                        # report is generated below) and no nested progress.
+                        LLVMObfuscator(progress_callback=None).obfuscate,
+                        working_source,
+                        _platform_config(target),
+                    ): target
+                    for target in targets
+                }
+                done = 0
+                for future in as_completed(futures):
+                    target = futures[future]
+                    done += 1
+                    try:
+                        platform_results[target.value] = future.result()
+                        message = f"{target.value} build complete"
+                    except Exception as exc:
+                        errors[target.value] = str(exc)
+                        self.logger.error(f"Platform build failed for {target.value}: {exc}")
+                        message = f"{target.value} build failed: {exc}"
+                    self._publish(
+                        job_id, "platform_build", 0.4 + 0.5 * done / len(targets),
+                        message, started=fanout_started,
+                    )
+
+        if not platform_results:
+            raise ObfuscationError(f"All platform builds failed: {errors}")
+
+        download_urls = {
+            platform_name: {
+                "path": result["output_file"],
+                "size_bytes": result["output_attributes"]["file_size"],
+            }
+            for platform_name, result in platform_results.items()
+        }
+
+        # The aggregate result mirrors the first successful target (report
+        # tooling expects the single-platform shape) plus the fan-out data.
+        primary = next(
+            platform_results[t.value] for t in targets if t.value in platform_results
+        )
+        job_data = dict(primary)
+        job_data.update({
+            "job_id": job_id,
+            "source_file": str(source_file.name),
+            "platform": "+".join(t.value for t in targets),
+            "platforms_built": sorted(platform_results),
+            "platforms_failed": errors,
+            "download_urls": download_urls,
+            "symbol_obfuscation": symbol_result or {"enabled": False},
+            "timestamp": get_timestamp(),
+        })
+        if string_result:
+            job_data["string_obfuscation"] = {
+                "total_strings": string_result.total_strings,
+                "encrypted_strings": string_result.encrypted_strings,
+                "encryption_method": string_result.encryption_method,
+                "encryption_percentage": string_result.encryption_percentage,
+            }
+        if profiler:
+            job_data["profiling"] = profiler.to_dict()
+
+        if self.reporter:
+            self._publish(job_id, "reporting", 0.95, "Generating reports")
+            report = self.reporter.generate_report(job_data)
+            exported = self.reporter.export(report, job_id or source_file.stem, config.output.report_formats)
+            job_data["report_paths"] = {fmt: str(path) for fmt, path in exported.items()}
+        return job_data
+
     # Internal helpers -----------------------------------------------------
 
+    @staticmethod
+    def _pass_targeting_flags(config: ObfuscationConfig) -> List[str]:
+        """Translate the function allow/deny lists into plugin opt flags."""
+        flags: List[str] = []
+        if config.passes.skip_functions:
+            flags.append("-obf-skip-functions=" + ",".join(config.passes.skip_functions))
+        if config.passes.only_functions:
+            flags.append("-obf-only-functions=" + ",".join(config.passes.only_functions))
+        return flags
+
+    @staticmethod
+    def _mba_budget_flags(config: ObfuscationConfig) -> List[str]:
+        """Translate the linear-MBA cost budget into plugin opt flags."""
+        passes = config.passes
+        if not passes.linear_mba:
+            return []
+        flags: List[str] = []
+        if passes.mba_max_depth is not None:
+            flags.append(f"-obf-mba-max-depth={passes.mba_max_depth}")
+        if passes.mba_growth_cap_percent is not None:
+            flags.append(f"-obf-mba-growth-cap={passes.mba_growth_cap_percent}")
+        if passes.mba_loop_aware:
+            flags.append("-obf-mba-loop-aware=1")
+        return flags
+
+    def _inject_decoys(self, working_source: Path, fake_loops: List, output_directory: Path) -> Path:
+        """Append the opaque-predicate decoys to the working source."""
+        source_text = working_source.read_text(encoding="utf-8", errors="ignore")
+        if "__obf_decoy_" in source_text:
+            self.logger.warning("Source already contains decoys; skipping injection")
+            return working_source
+        decoy_source = output_directory / f"{working_source.stem}_decoys{working_source.suffix}"
+        decoy_source.write_text(
+            source_text + self.fake_loop_generator.emit_source(fake_loops), encoding="utf-8"
+        )
+        self.logger.info("Injected %d opaque-predicate decoys", len(fake_loops))
+        return decoy_source
+
+    def _apply_source_transforms(
+        self,
+        source_file: Path,
+        config: ObfuscationConfig,
+        output_directory: Path,
+        job_id: Optional[str],
+        profiler: Optional[PipelineProfiler],
+    ):
+        """Run the platform-independent source stages (symbol renaming and
+        string encryption). Shared by the single-platform pipeline and the
+        multi-platform fan-out, which runs this once for all targets."""
+        # Symbol obfuscation (if enabled) - applied FIRST before other transformations
+        symbol_result = None
+        working_source = source_file
+        if config.advanced.symbol_obfuscation.enabled:
+            try:
+                stage_started = time.time()
+                self._publish(job_id, "symbol_obfuscation", 0.2, "Renaming symbols")
+                symbol_obfuscated_file = output_directory / f"{source_file.stem}_symbol_obfuscated{source_file.suffix}"
+                project_cache = None
+                if config.advanced.symbol_obfuscation.project_map:
+                    project_cache = ProjectSymbolCache(Path(config.advanced.symbol_obfuscation.project_map))
+                with maybe_stage(profiler, "symbol_obfuscation"):
+                    symbol_result = self.symbol_obfuscator.obfuscate(
+                        source_file=source_file,
+                        output_file=symbol_obfuscated_file,
+                        algorithm=config.advanced.symbol_obfuscation.algorithm,
+                        hash_length=config.advanced.symbol_obfuscation.hash_length,
+                        prefix_style=config.advanced.symbol_obfuscation.prefix_style,
+                        salt=config.advanced.symbol_obfuscation.salt,
+                        preserve_main=config.advanced.symbol_obfuscation.preserve_main,
+                        preserve_stdlib=config.advanced.symbol_obfuscation.preserve_stdlib,
+                        generate_map=True,
+                        map_file=output_directory / "symbol_map.json",
+                        is_cpp=source_file.suffix in [".cpp", ".cc", ".cxx"],
+                        project_cache=project_cache,
+                    )
+                working_source = symbol_obfuscated_file
+                self.logger.info(f"Symbol obfuscation complete: {symbol_result['symbols_obfuscated']} symbols renamed")
+                self._publish(
+                    job_id, "symbol_obfuscation", 0.25,
+                    f"{symbol_result['symbols_obfuscated']} symbols renamed",
+                    started=stage_started,
+                )
+            except Exception as e:
+                self.logger.warning(f"Symbol obfuscation failed, continuing without it: {e}")
+
+        # String encryption (if enabled) - applied to source content
+        string_result: Optional[StringEncryptionResult] = None
+        if config.advanced.string_encryption:
+            try:
+                stage_started = time.time()
+                self._publish(job_id, "string_encryption", 0.3, "Encrypting string literals")
+                # Get the symbol-obfuscated source if available, otherwise use original
+                current_source_content = working_source.read_text(encoding="utf-8", errors="replace")
+                string_config = config.advanced.string_encryption_config
+                if string_config.mode == "constexpr" and source_file.suffix not in [".cpp", ".cc", ".cxx", ".c++"]:
+                    self.logger.warning(
+                        "constexpr string encryption requires a C++ source, falling back to heap mode"
+                    )
+                    string_config = replace(string_config, mode="heap")
+                with maybe_stage(profiler, "string_encryption"):
+                    string_result = self.encryptor.encrypt_strings(current_source_content, string_config)
+
+                # Write the transformed source to a new file
+                string_encrypted_file = output_directory / f"{source_file.stem}_string_encrypted{source_file.suffix}"
+                string_encrypted_file.write_text(string_result.transformed_source, encoding="utf-8", errors="replace")
+                working_source = string_encrypted_file
+                self.logger.info(f"String encryption complete: {string_result.encrypted_strings}/{string_result.total_strings} strings encrypted")
+                self._publish(
+                    job_id, "string_encryption", 0.35,
+                    f"{string_result.encrypted_strings}/{string_result.total_strings} strings encrypted",
+                    started=stage_started,
+                )
+            except Exception as e:
+                self.logger.error(f"String encryption failed: {e}")
+                string_result = None
+
+        return working_source, symbol_result, string_result
+
     def _output_name(self, source_file: Path, platform_target: Platform) -> str:
         stem = source_file.stem
         if platform_target == Platform.WINDOWS:
@@ -303,8 +693,18 @@ class LLVMObfuscator:
         their own resource directory (stddef.h, stdint.h, etc.).
 
         This is needed when using bundled clang or custom-built clang that
-        doesn't have the compiler builtin headers.
+        doesn't have the compiler builtin headers. The probe can exec
+        `clang -print-resource-dir`, so the result is cached per compiler
+        binary and invalidated when that binary changes.
         """
+        resolved = compiler_path if "/" in compiler_path else (self.toolchain.which(compiler_path) or compiler_path)
+        return self.toolchain.cached(
+            f"resource-dir:{resolved}",
+            [resolved],
+            lambda: self._probe_resource_dir_flag(compiler_path),
+        )
+
+    def _probe_resource_dir_flag(self, compiler_path: str) -> List[str]:
         import platform as py_platform
         import subprocess
 
@@ -377,26 +777,60 @@ class LLVMObfuscator:
         )
         return []
 
+    # EH markers in textual IR: exception-aware calls and handler pads. The
+    # space prefixes avoid matching identifiers that merely contain the words.
+    _EH_TOKENS = (b" invoke ", b" landingpad ")
+    _IR_FUNC_RE = re.compile(rb'^define .*?@("[^"]+"|[^\s(]+)\(')
+
     def _has_exception_handling(self, ir_file: Path) -> bool:
         """
         Check if LLVM IR file contains C++ exception handling (invoke/landingpad).
 
-        Returns True if the IR uses exception handling, which is incompatible
-        with the OLLVM flattening pass.
+        Streams the file line by line (textual IR for a large TU can run to
+        hundreds of megabytes) and exits on the first match instead of
+        reading the whole file into memory.
         """
         try:
-            ir_content = ir_file.read_text(encoding='utf-8', errors='ignore')
-
-            # Check for invoke instructions (exception-aware function calls)
-            has_invoke = ' invoke ' in ir_content
+            with ir_file.open("rb") as stream:
+                for line in stream:
+                    if any(token in line for token in self._EH_TOKENS):
+                        return True
+            return False
+        except Exception as e:
+            self.logger.warning(f"Could not check for exception handling in IR: {e}")
+            return False
 
-            # Check for landingpad instructions (exception handlers)
-            has_landingpad = ' landingpad ' in ir_content
+    def _scan_exception_handling(self, ir_file: Path):
+        """Stream the textual IR and record which functions use EH.
 
-            return has_invoke or has_landingpad
+        Returns (eh_function_names, total_function_count). Memory stays
+        bounded by the read buffer; one pass over the file. Knowing the EH
+        functions by name lets the passes skip just those instead of the
+        whole file.
+        """
+        eh_functions: List[str] = []
+        total_functions = 0
+        current: Optional[str] = None
+        current_has_eh = False
+        try:
+            with ir_file.open("rb") as stream:
+                for line in stream:
+                    if line.startswith(b"define "):
+                        match = self._IR_FUNC_RE.match(line)
+                        total_functions += 1
+                        current = match.group(1).strip(b'"').decode("utf-8", errors="replace") if match else None
+                        current_has_eh = False
+                    elif current is not None:
+                        if line.startswith(b"}"):
+                            if current_has_eh:
+                                eh_functions.append(current)
+                            current = None
+                        elif not current_has_eh and any(token in line for token in self._EH_TOKENS):
+                            current_has_eh = True
         except Exception as e:
             self.logger.warning(f"Could not check for exception handling in IR: {e}")
-            return False
+            return [], 0
+        return eh_functions, total_functions
 
     def _compile(
         self,
@@ -405,6 +839,8 @@ class LLVMObfuscator:
         config: ObfuscationConfig,
         compiler_flags: List[str],
         enabled_passes: List[str],
+        ir_cycles: int = 1,
+        profiler: Optional[PipelineProfiler] = None,
     ) -> Dict:
         # Use absolute paths to avoid path resolution issues
         source_abs = source.resolve()
@@ -549,11 +985,30 @@ class LLVMObfuscator:
                     ir_cmd.extend(["--target=x86_64-w64-mingw32"])
 
                 self.logger.info("Step 1/3: Compiling to LLVM IR")
-                run_command(ir_cmd, cwd=source_abs.parent)
-
-                # Check for C++ exception handling (incompatible with ALL OLLVM passes)
-                if self._has_exception_handling(ir_file):
-                    if enabled_passes:
+                with maybe_stage(profiler, "frontend_parse"):
+                    run_command(ir_cmd, cwd=source_abs.parent)
+
+                # Check for C++ exception handling (incompatible with ALL OLLVM
+                # passes). The streaming scan names the offending functions, so
+                # a file that mixes EH and EH-free code keeps its passes on the
+                # EH-free part via the function targeting flags.
+                eh_excluded: List[str] = []
+                eh_functions, total_functions = self._scan_exception_handling(ir_file)
+                if eh_functions and enabled_passes:
+                    if len(eh_functions) < total_functions:
+                        eh_excluded = eh_functions
+                        warning_msg = (
+                            f"C++ exception handling detected in {len(eh_functions)} of "
+                            f"{total_functions} functions (invoke/landingpad instructions). "
+                            "OLLVM passes are incompatible with C++ exception handling; "
+                            "the affected functions are excluded and the passes apply to the rest."
+                        )
+                        self.logger.warning(warning_msg)
+                        warnings.append(warning_msg)
+                        combined = list(config.passes.skip_functions)
+                        combined.extend(name for name in eh_excluded if name not in combined)
+                        config = replace(config, passes=replace(config.passes, skip_functions=combined))
+                    else:
                         warning_msg = (
                             "C++ exception handling detected in IR (invoke/landingpad instructions). "
                             "ALL OLLVM passes are incompatible with C++ exception handling and will be disabled. "
@@ -663,18 +1118,78 @@ class LLVMObfuscator:
                         )
                         raise ObfuscationError("Compatible opt binary not found")
 
-                # Build the passes pipeline
+                # Build the passes pipeline and apply it per cycle. The
+                # frontend already ran once; each additional cycle is just
+                # another opt invocation over the previous cycle's bitcode.
                 passes_pipeline = ",".join(enabled_passes)
-                opt_cmd = [
-                    str(opt_binary),
-                    "-load-pass-plugin=" + str(plugin_path),
-                    f"-passes={passes_pipeline}",
-                    str(ir_file),
-                    "-o", str(obfuscated_ir)
-                ]
-
-                self.logger.info("Step 2/3: Applying OLLVM passes via opt")
-                run_command(opt_cmd, cwd=source_abs.parent)
+                # Function-level targeting and the MBA cost budget ride on
+                # plugin flags; older plugin builds without them degrade to
+                # whole-binary application at default intensity.
+                targeting_flags = self._pass_targeting_flags(config) + self._mba_budget_flags(config)
+                current_ir = ir_file
+                for cycle in range(1, ir_cycles + 1):
+                    cycle_ir = (
+                        obfuscated_ir
+                        if cycle == ir_cycles
+                        else destination_abs.parent / f"{destination_abs.stem}_obfuscated_cycle{cycle}.bc"
+                    )
+                    opt_cmd = [
+                        str(opt_binary),
+                        "-load-pass-plugin=" + str(plugin_path),
+                        f"-passes={passes_pipeline}",
+                        str(current_ir),
+                        "-o", str(cycle_ir)
+                    ] + targeting_flags
+                    if profiler:
+                        opt_cmd.append("-time-passes")
+
+                    self.logger.info("Step 2/3: Applying OLLVM passes via opt (cycle %d/%d)", cycle, ir_cycles)
+                    with maybe_stage(profiler, f"opt_passes_cycle_{cycle}"):
+                        try:
+                            _, _, opt_stderr = run_command(opt_cmd, cwd=source_abs.parent)
+                        except ObfuscationError as exc:
+                            if not targeting_flags or "argument" not in str(exc).lower():
+                                raise
+                            if eh_excluded:
+                                # Without targeting support the passes would hit
+                                # the EH functions too; that is the one case
+                                # where retrying flag-less is unsafe.
+                                warning_msg = (
+                                    "Pass plugin does not support function targeting flags; "
+                                    "disabling all OLLVM passes for this exception-handling file"
+                                )
+                                self.logger.warning(warning_msg)
+                                warnings.append(warning_msg)
+                                fallback_cmd = [compiler, str(source_abs), "-o", str(destination_abs)] + compiler_flags
+                                if resource_dir_flags:
+                                    fallback_cmd.extend(resource_dir_flags)
+                                if config.platform == Platform.WINDOWS:
+                                    fallback_cmd.extend(["--target=x86_64-w64-mingw32"])
+                                run_command(fallback_cmd, cwd=source_abs.parent)
+                                for leftover in (ir_file, current_ir, cycle_ir):
+                                    if leftover.exists():
+                                        leftover.unlink()
+                                return {
+                                    "applied_passes": [],
+                                    "warnings": warnings,
+                                    "disabled_passes": enabled_passes,
+                                }
+                            warning_msg = (
+                                "Pass plugin does not support targeting/budget flags; "
+                                "applying passes to all functions at default intensity"
+                            )
+                            self.logger.warning(warning_msg)
+                            warnings.append(warning_msg)
+                            for flag in targeting_flags:
+                                opt_cmd.remove(flag)
+                            targeting_flags = []
+                            _, _, opt_stderr = run_command(opt_cmd, cwd=source_abs.parent)
+                        if profiler:
+                            profiler.record_time_passes(opt_stderr)
+
+                    if current_ir != ir_file and current_ir.exists():
+                        current_ir.unlink()
+                    current_ir = cycle_ir
 
                 # Step 3: Compile obfuscated IR to binary
                 # If using bundled clang, strip LTO flags (bundled clang doesn't have LLVMgold.so)
@@ -691,7 +1206,8 @@ class LLVMObfuscator:
                     final_cmd.extend(["--target=x86_64-w64-mingw32"])
 
                 self.logger.info("Step 3/3: Compiling obfuscated IR to binary")
-                run_command(final_cmd, cwd=source_abs.parent)
+                with maybe_stage(profiler, "link"):
+                    run_command(final_cmd, cwd=source_abs.parent)
 
                 # Cleanup temporary files
                 if ir_file.exists():
@@ -741,7 +1257,8 @@ class LLVMObfuscator:
 
             if config.platform == Platform.WINDOWS:
                 command.extend(["--target=x86_64-w64-mingw32"])
-            run_command(command, cwd=source_abs.parent)
+            with maybe_stage(profiler, "compile_and_link"):
+                run_command(command, cwd=source_abs.parent)
             return {
                 "applied_passes": actually_applied_passes,
                 "warnings": warnings,
@@ -839,6 +1356,7 @@ class LLVMObfuscator:
             "count": len(fake_loops),
             "types": [loop.loop_type for loop in fake_loops],
             "locations": [loop.location for loop in fake_loops],
+            "predicates": [loop.predicate for loop in fake_loops],
         }
         cycles_completed = {
             "total_cycles": cycles,
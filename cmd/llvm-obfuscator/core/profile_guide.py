@@ -0,0 +1,186 @@
+"""
+Profile-guided obfuscation budgeting.
+
+Manual --skip-functions lists require knowing the hot paths up front. The
+adaptive level automates it: the pipeline builds an instrumented copy of the
+source, runs a user-supplied workload against it, collects per-function
+execution counts through LLVM's profile instrumentation, and excludes the
+hottest functions from the OLLVM passes until the predicted runtime overhead
+fits a user-specified budget. The cost model is deliberately simple: measured
+pass overhead concentrates in the functions the workload actually executes,
+so predicted overhead = (runtime share left obfuscated) x (assumed per-pass
+overhead). Every per-function decision lands in the report.
+
+Profiling needs clang (already required by the pipeline) and llvm-profdata;
+if either the tools or the workload fail, the plan is abandoned with a
+warning and the job continues exactly as a non-adaptive run.
+"""
+
+from __future__ import annotations
+
+import os
+import re
+import shlex
+import subprocess
+from pathlib import Path
+from typing import Dict, List, Optional
+
+from .config import ObfuscationConfig
+from .toolchain import get_toolchain
+from .utils import create_logger, run_command
+
+logger = create_logger(__name__)
+
+# Flattening/bogus-CF overhead measured on the README benchmarks; the budget
+# math assumes obfuscated code slows down by roughly this factor.
+ASSUMED_PASS_OVERHEAD_PERCENT = 20.0
+
+_FUNC_RE = re.compile(r"^ {2}(\S+):$")
+_COUNT_RE = re.compile(r"^\s+Function count: (\d+)$")
+
+
+class ProfileGuidedPlanner:
+    """Build, run, measure, decide: per-function pass exclusion to budget."""
+
+    WORKLOAD_TIMEOUT = 300
+
+    def __init__(self) -> None:
+        self.logger = create_logger(__name__)
+        self.toolchain = get_toolchain()
+
+    def plan(
+        self,
+        source_file: Path,
+        config: ObfuscationConfig,
+        output_directory: Path,
+    ) -> Optional[Dict]:
+        """Produce the exclusion plan, or None when profiling is unavailable.
+
+        The returned dict records the workload, total samples, the budget,
+        the predicted overhead after exclusion, and one decision per profiled
+        function; "excluded_functions" is what the caller feeds into
+        passes.skip_functions.
+        """
+        workload = config.profile_guided.workload
+        if not workload:
+            self.logger.warning(
+                "Adaptive level selected but no profile workload configured; "
+                "passes will apply to all functions"
+            )
+            return None
+        profdata_tool = self.toolchain.which("llvm-profdata")
+        if not profdata_tool:
+            self.logger.warning(
+                "llvm-profdata not found; skipping profile-guided planning"
+            )
+            return None
+
+        try:
+            instrumented = self._build_instrumented(source_file, output_directory)
+            profraw = output_directory / "workload.profraw"
+            self._run_workload(workload, instrumented, profraw)
+            counts = self._collect_counts(profdata_tool, profraw, output_directory)
+        except Exception as exc:
+            self.logger.warning(f"Profile collection failed ({exc}); continuing unguided")
+            return None
+        if not counts:
+            self.logger.warning("Workload produced no function counts; continuing unguided")
+            return None
+
+        budget = config.profile_guided.overhead_budget_percent
+        decisions, excluded, predicted = self._decide(counts, budget)
+        self.logger.info(
+            "Profile-guided plan: %d/%d functions excluded, predicted overhead %.2f%% (budget %.2f%%)",
+            len(excluded), len(counts), predicted, budget,
+        )
+        return {
+            "enabled": True,
+            "workload": workload,
+            "total_samples": sum(counts.values()),
+            "overhead_budget_percent": budget,
+            "assumed_pass_overhead_percent": ASSUMED_PASS_OVERHEAD_PERCENT,
+            "predicted_overhead_percent": round(predicted, 2),
+            "excluded_functions": excluded,
+            "functions": decisions,
+        }
+
+    # Internal ---------------------------------------------------------------
+
+    def _build_instrumented(self, source_file: Path, output_directory: Path) -> Path:
+        """Compile the untouched source with LLVM profile instrumentation."""
+        compiler = "clang++" if source_file.suffix in [".cpp", ".cc", ".cxx"] else "clang"
+        instrumented = output_directory / f"{source_file.stem}_instrumented"
+        run_command([
+            compiler, str(source_file), "-o", str(instrumented),
+            "-O2", "-fprofile-instr-generate", "-fcoverage-mapping",
+        ])
+        return instrumented
+
+    def _run_workload(self, workload: str, binary: Path, profraw: Path) -> None:
+        """Run the workload command with the instrumented binary.
+
+        "{binary}" in the command is substituted; without a placeholder the
+        binary path is appended as the last argument.
+        """
+        if "{binary}" in workload:
+            command = [
+                part.replace("{binary}", str(binary)) for part in shlex.split(workload)
+            ]
+        else:
+            command = shlex.split(workload) + [str(binary)]
+        env = dict(os.environ, LLVM_PROFILE_FILE=str(profraw))
+        self.logger.info(f"Running profile workload: {' '.join(command)}")
+        # A non-zero exit is fine - workloads may exercise error paths - but
+        # the run must leave a raw profile behind.
+        subprocess.run(command, env=env, capture_output=True, timeout=self.WORKLOAD_TIMEOUT)
+        if not profraw.exists():
+            raise RuntimeError("workload did not produce a raw profile")
+
+    def _collect_counts(self, profdata_tool: str, profraw: Path, output_directory: Path) -> Dict[str, int]:
+        profdata = output_directory / "workload.profdata"
+        run_command([profdata_tool, "merge", "-o", str(profdata), str(profraw)])
+        _, stdout, _ = run_command([
+            profdata_tool, "show", "--all-functions", "--text", str(profdata)
+        ])
+        counts: Dict[str, int] = {}
+        current: Optional[str] = None
+        for line in stdout.splitlines():
+            name_match = _FUNC_RE.match(line)
+            if name_match:
+                current = name_match.group(1)
+                continue
+            count_match = _COUNT_RE.match(line)
+            if count_match and current:
+                counts[current] = int(count_match.group(1))
+                current = None
+        return counts
+
+    @staticmethod
+    def _decide(counts: Dict[str, int], budget_percent: float) -> tuple:
+        """Exclude the hottest functions until the predicted overhead fits.
+
+        Predicted overhead is the runtime share still obfuscated times the
+        assumed per-pass overhead; functions are pulled out hottest-first,
+        so cold code keeps the heaviest treatment.
+        """
+        total = sum(counts.values()) or 1
+        ranked: List[tuple] = sorted(counts.items(), key=lambda item: item[1], reverse=True)
+        obfuscated_share = 1.0
+        excluded: List[str] = []
+        for name, count in ranked:
+            if obfuscated_share * ASSUMED_PASS_OVERHEAD_PERCENT <= budget_percent:
+                break
+            if count == 0:
+                break  # only cold functions left; excluding them buys nothing
+            excluded.append(name)
+            obfuscated_share -= count / total
+        predicted = max(obfuscated_share, 0.0) * ASSUMED_PASS_OVERHEAD_PERCENT
+        decisions = {
+            name: {
+                "samples": count,
+                "runtime_share": round(count / total, 4),
+                "decision": "skip" if name in excluded else "obfuscate",
+            }
+            for name, count in ranked
+        }
+        return decisions, excluded, predicted
@@ -0,0 +1,91 @@
+from __future__ import annotations
+
+import re
+import time
+from contextlib import contextmanager
+from typing import Dict, List, Optional
+
+
+class PipelineProfiler:
+    """Collects a timing tree for one obfuscation run.
+
+    Stages are timed with the stage() context manager and may nest
+    (e.g. "compile_cycle_1" containing "frontend_parse" / "opt_passes" /
+    "link"). Per-pass numbers come from opt's -time-passes report, parsed
+    with record_time_passes(). The whole tree lands in the JSON report and
+    feeds the HTML summary table, so slow passes can be spotted per job.
+    """
+
+    def __init__(self) -> None:
+        self.started_at = time.time()
+        self._root: List[Dict] = []
+        self._stack: List[Dict] = []
+
+    @contextmanager
+    def stage(self, name: str):
+        node = {"stage": name, "duration_seconds": 0.0, "children": []}
+        parent = self._stack[-1]["children"] if self._stack else self._root
+        parent.append(node)
+        self._stack.append(node)
+        started = time.time()
+        try:
+            yield node
+        finally:
+            node["duration_seconds"] = round(time.time() - started, 4)
+            self._stack.pop()
+
+    def annotate(self, key: str, value) -> None:
+        """Attach extra data (e.g. per-pass timings) to the current stage."""
+        if self._stack:
+            self._stack[-1][key] = value
+
+    def record_time_passes(self, stderr: str) -> List[Dict]:
+        """Parse opt/clang -time-passes output into per-pass wall times.
+
+        Handles the new-PM report format, e.g.:
+           ---Wall Time---  --- Name ---
+           0.0123 ( 45.6%)  FlatteningPass
+        Returns entries sorted by wall time, descending, and attaches them
+        to the current stage under "pass_timings".
+        """
+        cell = re.compile(r"([0-9]+\.[0-9]+)\s*\(\s*[0-9.]+%\)")
+        timings: List[Dict] = []
+        in_report = False
+        for line in stderr.splitlines():
+            if "Pass execution timing report" in line:
+                in_report = True
+                timings = []  # keep the last report if several are emitted
+                continue
+            if not in_report:
+                continue
+            cells = cell.findall(line)
+            if not cells:
+                continue
+            # Wall time is the last timing column; the pass name follows it.
+            name = line[line.rindex(")") + 1:].strip()
+            if not name or name == "Total":
+                continue
+            timings.append({
+                "pass": name,
+                "wall_seconds": float(cells[-1]),
+            })
+        timings.sort(key=lambda entry: entry["wall_seconds"], reverse=True)
+        if timings:
+            self.annotate("pass_timings", timings)
+        return timings
+
+    def to_dict(self) -> Dict:
+        return {
+            "total_seconds": round(time.time() - self.started_at, 4),
+            "stages": self._root,
+        }
+
+
+@contextmanager
+def maybe_stage(profiler: Optional[PipelineProfiler], name: str):
+    """stage() when profiling is on, a no-op otherwise."""
+    if profiler is None:
+        yield None
+    else:
+        with profiler.stage(name) as node:
+            yield node
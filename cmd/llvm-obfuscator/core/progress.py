@@ -1,10 +1,14 @@
 from __future__ import annotations
 
 import asyncio
+import threading
+import time
 from asyncio import Queue
-import asyncio
-from dataclasses import dataclass
-from typing import AsyncIterator, Dict
+from dataclasses import dataclass, field
+from typing import AsyncIterator, Dict, List, Optional, Tuple
+
+# Stages that end a job's event stream; subscribers stop after seeing one.
+TERMINAL_STAGES = {"completed", "failed"}
 
 
 @dataclass
@@ -13,33 +17,82 @@ class ProgressEvent:
     stage: str
     progress: float
     message: str
+    pass_name: Optional[str] = None
+    elapsed_seconds: Optional[float] = None
+    timestamp: float = field(default_factory=time.time)
+
+    def to_dict(self) -> Dict:
+        return {
+            "job_id": self.job_id,
+            "stage": self.stage,
+            "progress": self.progress,
+            "message": self.message,
+            "pass_name": self.pass_name,
+            "elapsed_seconds": self.elapsed_seconds,
+            "timestamp": self.timestamp,
+        }
 
 
 class ProgressTracker:
-    """Simple progress broadcaster for WebSocket subscribers."""
+    """Pub/sub progress bus for WebSocket subscribers.
 
-    def __init__(self) -> None:
-        self._queues: Dict[str, Queue[ProgressEvent]] = {}
+    Publishers (the obfuscation pipeline, running on executor worker
+    threads) call publish_sync; every event is appended to a bounded
+    per-job history and fanned out to live subscribers through their own
+    event-loop queues, so the WebSocket handler just awaits events instead
+    of polling. Late subscribers get the history replayed first, which
+    doubles as the job's progress snapshot.
+    """
 
-    def _get_queue(self, job_id: str) -> Queue[ProgressEvent]:
-        if job_id not in self._queues:
-            self._queues[job_id] = Queue()
-        return self._queues[job_id]
+    def __init__(self, history_limit: int = 500) -> None:
+        self.history_limit = history_limit
+        self._lock = threading.Lock()
+        self._history: Dict[str, List[ProgressEvent]] = {}
+        self._subscribers: Dict[str, List[Tuple[asyncio.AbstractEventLoop, Queue]]] = {}
 
     async def publish(self, event: ProgressEvent) -> None:
-        queue = self._get_queue(event.job_id)
-        await queue.put(event)
+        self.publish_sync(event)
 
     def publish_sync(self, event: ProgressEvent) -> None:
+        """Thread-safe publish; usable from worker threads and the event loop."""
+        with self._lock:
+            history = self._history.setdefault(event.job_id, [])
+            history.append(event)
+            if len(history) > self.history_limit:
+                del history[: len(history) - self.history_limit]
+            subscribers = list(self._subscribers.get(event.job_id, []))
+        for loop, queue in subscribers:
+            loop.call_soon_threadsafe(queue.put_nowait, event)
+
+    def snapshot(self, job_id: str) -> List[ProgressEvent]:
+        """The events published so far for a job, oldest first."""
+        with self._lock:
+            return list(self._history.get(job_id, []))
+
+    def clear(self, job_id: str) -> None:
+        with self._lock:
+            self._history.pop(job_id, None)
+
+    async def subscribe(self, job_id: str, replay: bool = True) -> AsyncIterator[ProgressEvent]:
+        loop = asyncio.get_running_loop()
+        queue: Queue[ProgressEvent] = Queue()
+        with self._lock:
+            backlog = list(self._history.get(job_id, [])) if replay else []
+            self._subscribers.setdefault(job_id, []).append((loop, queue))
         try:
-            loop = asyncio.get_running_loop()
-        except RuntimeError:
-            asyncio.run(self.publish(event))
-            return
-        loop.create_task(self.publish(event))
-
-    async def subscribe(self, job_id: str) -> AsyncIterator[ProgressEvent]:
-        queue = self._get_queue(job_id)
-        while True:
-            event = await queue.get()
-            yield event
+            for event in backlog:
+                yield event
+                if event.stage in TERMINAL_STAGES:
+                    return
+            while True:
+                event = await queue.get()
+                yield event
+                if event.stage in TERMINAL_STAGES:
+                    return
+        finally:
+            with self._lock:
+                subscribers = self._subscribers.get(job_id, [])
+                if (loop, queue) in subscribers:
+                    subscribers.remove((loop, queue))
+                if not subscribers:
+                    self._subscribers.pop(job_id, None)
@@ -0,0 +1,197 @@
+"""
+Content-addressed, compressed, indexed report store.
+
+The reports/ tree keeps a full directory per job, so resubmitted sources and
+the shared decryptor boilerplate are stored once per job and report lookup
+degenerates into a directory walk as the tree grows. ReportStore archives job
+artifacts content-addressed: blobs are keyed by their sha256, stored once no
+matter how many jobs reference them, and compressed at rest (zlib - this tree
+has no third-party compression dependency; the container format records the
+codec so zstd can be swapped in later without migrating). A SQLite manifest -
+the same discipline as the job registry - maps (job_id, artifact name) to its
+blob in one indexed lookup, and expired jobs are garbage-collected
+opportunistically on ingest, dropping blobs only when their last reference is
+gone.
+"""
+
+from __future__ import annotations
+
+import hashlib
+import os
+import sqlite3
+import tempfile
+import zlib
+from datetime import datetime, timedelta
+from pathlib import Path
+from typing import Dict, List, Optional
+
+from .utils import create_logger, ensure_directory
+
+logger = create_logger(__name__)
+
+# Artifacts older than this are collected; 0 disables expiry. Defaults to the
+# job registry's TTL so the store and the job table age out together.
+DEFAULT_REPORT_TTL_SECONDS = int(
+    os.environ.get(
+        "OBFUSCATOR_REPORT_TTL_SECONDS",
+        os.environ.get("OBFUSCATOR_JOB_TTL_SECONDS", str(7 * 24 * 3600)),
+    )
+)
+
+
+class ReportStore:
+    """Deduplicated blob store with a SQLite manifest index."""
+
+    _SCHEMA = """
+    CREATE TABLE IF NOT EXISTS blobs (
+        sha256 TEXT PRIMARY KEY,
+        size INTEGER NOT NULL,
+        compressed_size INTEGER NOT NULL,
+        codec TEXT NOT NULL DEFAULT 'zlib'
+    );
+    CREATE TABLE IF NOT EXISTS artifacts (
+        job_id TEXT NOT NULL,
+        name TEXT NOT NULL,
+        sha256 TEXT NOT NULL REFERENCES blobs(sha256),
+        created_at TEXT NOT NULL,
+        PRIMARY KEY (job_id, name)
+    );
+    CREATE INDEX IF NOT EXISTS idx_artifacts_sha ON artifacts(sha256);
+    CREATE INDEX IF NOT EXISTS idx_artifacts_created_at ON artifacts(created_at);
+    """
+
+    def __init__(self, root: Path, ttl_seconds: int = DEFAULT_REPORT_TTL_SECONDS) -> None:
+        self.root = Path(root)
+        self.blob_root = self.root / "blobs"
+        self.ttl_seconds = ttl_seconds
+        ensure_directory(self.blob_root)
+        self.db_path = self.root / "manifest.db"
+        with self._connect() as conn:
+            conn.executescript(self._SCHEMA)
+
+    # Ingest -----------------------------------------------------------------
+
+    def ingest_directory(self, job_id: str, directory: Path) -> Dict[str, str]:
+        """Archive every regular file under a job directory.
+
+        Returns {artifact name: sha256}. Artifact names are paths relative to
+        the directory, so nested layouts (per-platform subdirectories) keep
+        their structure. Expired jobs are collected on the way in.
+        """
+        self.purge_expired()
+        stored: Dict[str, str] = {}
+        if not directory.exists():
+            return stored
+        for path in sorted(directory.rglob("*")):
+            if path.is_file() and path != self.db_path:
+                name = str(path.relative_to(directory))
+                stored[name] = self.store_file(job_id, path, name)
+        return stored
+
+    def store_file(self, job_id: str, path: Path, name: Optional[str] = None) -> str:
+        return self.store_bytes(job_id, name or path.name, path.read_bytes())
+
+    def store_bytes(self, job_id: str, name: str, data: bytes) -> str:
+        """Store one artifact; identical content lands on the existing blob."""
+        digest = hashlib.sha256(data).hexdigest()
+        blob_path = self._blob_path(digest)
+        if not blob_path.exists():
+            compressed = zlib.compress(data, 6)
+            ensure_directory(blob_path.parent)
+            fd, tmp_path = tempfile.mkstemp(dir=str(blob_path.parent), prefix=".blob-", suffix=".tmp")
+            with os.fdopen(fd, "wb") as f:
+                f.write(compressed)
+            os.replace(tmp_path, blob_path)
+            compressed_size = len(compressed)
+        else:
+            compressed_size = blob_path.stat().st_size
+        with self._connect() as conn:
+            conn.execute(
+                "INSERT OR IGNORE INTO blobs (sha256, size, compressed_size) VALUES (?, ?, ?)",
+                (digest, len(data), compressed_size),
+            )
+            conn.execute(
+                "INSERT OR REPLACE INTO artifacts (job_id, name, sha256, created_at) VALUES (?, ?, ?, ?)",
+                (job_id, name, digest, datetime.utcnow().isoformat()),
+            )
+        return digest
+
+    # Lookup -----------------------------------------------------------------
+
+    def read(self, job_id: str, name: str) -> Optional[bytes]:
+        """O(1) manifest lookup, then one blob read; None if not stored."""
+        with self._connect() as conn:
+            row = conn.execute(
+                "SELECT sha256 FROM artifacts WHERE job_id = ? AND name = ?",
+                (job_id, name),
+            ).fetchone()
+        if not row:
+            return None
+        blob_path = self._blob_path(row[0])
+        if not blob_path.exists():
+            logger.warning("Manifest references missing blob %s", row[0])
+            return None
+        return zlib.decompress(blob_path.read_bytes())
+
+    def artifact_names(self, job_id: str) -> List[str]:
+        with self._connect() as conn:
+            rows = conn.execute(
+                "SELECT name FROM artifacts WHERE job_id = ? ORDER BY name", (job_id,)
+            ).fetchall()
+        return [row[0] for row in rows]
+
+    def stats(self) -> Dict:
+        with self._connect() as conn:
+            artifacts, jobs = conn.execute(
+                "SELECT COUNT(*), COUNT(DISTINCT job_id) FROM artifacts"
+            ).fetchone()
+            blobs, logical, compressed = conn.execute(
+                "SELECT COUNT(*), COALESCE(SUM(size), 0), COALESCE(SUM(compressed_size), 0) FROM blobs"
+            ).fetchone()
+        return {
+            "jobs": jobs,
+            "artifacts": artifacts,
+            "blobs": blobs,
+            "logical_bytes": logical,
+            "stored_bytes": compressed,
+            "dedup_ratio": round(artifacts / blobs, 2) if blobs else 1.0,
+        }
+
+    # Garbage collection -----------------------------------------------------
+
+    def purge_expired(self) -> int:
+        """Drop artifacts past the TTL and any blobs they orphaned."""
+        if self.ttl_seconds <= 0:
+            return 0
+        cutoff = (datetime.utcnow() - timedelta(seconds=self.ttl_seconds)).isoformat()
+        with self._connect() as conn:
+            removed = conn.execute(
+                "DELETE FROM artifacts WHERE created_at < ?", (cutoff,)
+            ).rowcount
+            if not removed:
+                return 0
+            orphans = [
+                row[0]
+                for row in conn.execute(
+                    "SELECT sha256 FROM blobs WHERE sha256 NOT IN (SELECT sha256 FROM artifacts)"
+                ).fetchall()
+            ]
+            conn.execute(
+                "DELETE FROM blobs WHERE sha256 NOT IN (SELECT sha256 FROM artifacts)"
+            )
+        for digest in orphans:
+            try:
+                self._blob_path(digest).unlink()
+            except OSError:  # pragma: no cover - GC is best-effort
+                pass
+        if removed:
+            logger.info("Report store GC: removed %d artifacts, %d blobs", removed, len(orphans))
+        return removed
+
+    # Internal ---------------------------------------------------------------
+
+    def _blob_path(self, digest: str) -> Path:
+        return self.blob_root / digest[:2] / digest
+
+    def _connect(self) -> sqlite3.Connection:
+        return sqlite3.connect(self.db_path)
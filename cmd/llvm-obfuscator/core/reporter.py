@@ -32,6 +32,7 @@ class ObfuscationReport:
                 "comparison": job_data.get("comparison", {}),  # Before/after comparison
                 "bogus_code_info": job_data.get("bogus_code_info", {}),
                 "cycles_completed": job_data.get("cycles_completed", {}),
+                "profiling": job_data.get("profiling", {}),  # Stage/pass timing tree (profile mode)
                 "string_obfuscation": job_data.get("string_obfuscation", {}),
                 "fake_loops_inserted": job_data.get("fake_loops_inserted", {}),
                 "symbol_obfuscation": job_data.get("symbol_obfuscation", {}),
@@ -147,6 +148,10 @@ class ObfuscationReport:
         symbols_obfuscated = symbol_obf.get("symbols_obfuscated", 0)
         symbol_algorithm = symbol_obf.get("algorithm", "N/A")
 
+        # Profiling timing tree (only present in profile mode)
+        profiling = report.get("profiling", {})
+        profiling_html = self._render_profiling_rows(profiling.get("stages", []))
+
         html = f"""
 <!DOCTYPE html>
 <html lang="en">
@@ -579,6 +584,24 @@ class ObfuscationReport:
         </tbody>
     </table>''' if cycles_html else ''}
 
+    {f'''<!-- Pipeline Profiling -->
+    <h2>Pipeline Profiling</h2>
+    <div class="field">
+        <div class="field-label">Total Pipeline Time:</div>
+        <div class="field-value">{profiling.get('total_seconds', 0)} s</div>
+    </div>
+    <table>
+        <thead>
+            <tr>
+                <th>Stage / Pass</th>
+                <th>Wall Time</th>
+            </tr>
+        </thead>
+        <tbody>
+            {profiling_html}
+        </tbody>
+    </table>''' if profiling else ''}
+
     <!-- String Obfuscation -->
     <h2>String Obfuscation</h2>
     <div class="field">
@@ -643,6 +666,23 @@ class ObfuscationReport:
         """
         return html
 
+    def _render_profiling_rows(self, stages: List[Dict[str, Any]], depth: int = 0) -> str:
+        """Render the profiling timing tree as indented table rows."""
+        rows = ""
+        indent = "&nbsp;" * 4 * depth
+        for stage in stages:
+            rows += (
+                f'<tr><td>{indent}{stage.get("stage", "?")}</td>'
+                f'<td>{stage.get("duration_seconds", 0)} s</td></tr>'
+            )
+            for timing in stage.get("pass_timings", []):
+                rows += (
+                    f'<tr><td>{indent}&nbsp;&nbsp;&nbsp;&nbsp;<code>{timing.get("pass", "?")}</code></td>'
+                    f'<td>{timing.get("wall_seconds", 0)} s</td></tr>'
+                )
+            rows += self._render_profiling_rows(stage.get("children", []), depth + 1)
+        return rows
+
     def _render_markdown(self, report: Dict[str, Any], job_id: str) -> str:
         """Render a markdown version of the report."""
         timestamp = datetime.utcnow().strftime("%Y-%m-%d %H:%M:%S UTC")
@@ -729,7 +769,7 @@ class ObfuscationReport:
 
 ---
 
-## 🔐 String Obfuscation
+{self._format_profiling_markdown(report.get('profiling', {}))}## 🔐 String Obfuscation
 
 - **Total Strings:** {string_obf.get('total_strings', 0)}
 - **Encrypted Strings:** {string_obf.get('encrypted_strings', 0)}
@@ -756,6 +796,29 @@ class ObfuscationReport:
 """
         return md
 
+    def _format_profiling_markdown(self, profiling: Dict[str, Any]) -> str:
+        """Format the profiling timing tree for markdown output."""
+        if not profiling:
+            return ""
+
+        md = "## ⏱️ Pipeline Profiling\n\n"
+        md += f"**Total Pipeline Time:** {profiling.get('total_seconds', 0)} s\n\n"
+        md += "| Stage / Pass | Wall Time |\n|--------------|----------|\n"
+
+        def walk(stages: List[Dict[str, Any]], depth: int) -> str:
+            rows = ""
+            prefix = "&nbsp;" * 4 * depth
+            for stage in stages:
+                rows += f"| {prefix}{stage.get('stage', '?')} | {stage.get('duration_seconds', 0)} s |\n"
+                for timing in stage.get("pass_timings", []):
+                    rows += f"| {prefix}&nbsp;&nbsp;&nbsp;&nbsp;`{timing.get('pass', '?')}` | {timing.get('wall_seconds', 0)} s |\n"
+                rows += walk(stage.get("children", []), depth + 1)
+            return rows
+
+        md += walk(profiling.get("stages", []), 0)
+        md += "\n---\n\n"
+        return md
+
     def _format_warnings_markdown(self, warnings: List[str]) -> str:
         """Format warnings list for markdown output."""
         if not warnings:
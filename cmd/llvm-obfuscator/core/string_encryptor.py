@@ -4,7 +4,9 @@ import logging
 import random
 import re
 from dataclasses import dataclass
-from typing import Dict, List
+from typing import Dict, List, Optional, Tuple
+
+from .config import StringEncryptionConfiguration
 
 
 @dataclass
@@ -18,7 +20,42 @@ class StringEncryptionResult:
 
 
 class XORStringEncryptor:
-    """XOR-based string obfuscator with actual source transformation."""
+    """XOR-based string obfuscator with actual source transformation.
+
+    Scanning is a single lexer pass: one master-regex sweep tokenizes
+    comments, char literals, raw strings, and ordinary string literals with
+    full context (brace depth, preprocessor lines), so every candidate is
+    classified exactly once. All rewrites - literal replacements, const-global
+    declaration rewrites, the injected decryptor - are collected as
+    (start, end, text) edits and applied in one offset-sorted splice, giving
+    linear scaling in source size instead of one full rescan per phase.
+    """
+
+    # One alternation covers every construct that changes lexing context.
+    # Everything between matches is plain code with no newlines, quotes, or
+    # braces, so finditer skips it at C speed.
+    _TOKEN_RE = re.compile(
+        r'//[^\n]*'                                            # line comment
+        r'|/\*.*?\*/'                                          # block comment
+        r"|'(?:\\.|[^'\\\n])*'"                                # char literal
+        r'|(?:u8|u|U|L)?R"(?P<rsdelim>[^()\\\s]*)\(.*?\)(?P=rsdelim)"'  # raw string
+        r'|(?:u8|u|U|L)?"(?:\\.|[^"\\\n])*"'                   # ordinary string
+        r'|[{}\n]',
+        re.DOTALL,
+    )
+
+    # Const global declarations: matched against the single line holding a
+    # string literal at global scope, never against the whole source.
+    _CONST_C_RE = re.compile(r'^\s*(static\s+)?const\s+char\s*\*\s+(\w+)\s*=\s*"([^"]+)"\s*;')
+    _CONST_CPP_RE = re.compile(r'^\s*(static\s+)?const\s+std::string\s+(\w+)\s*=\s*"([^"]+)"\s*;')
+    _LOCAL_CONST_RE = re.compile(r'const char\*\s+(\w+)\s*=')
+
+    # Skip format strings, usage messages, and strings used in output contexts.
+    _INLINE_SKIP_PATTERNS = [
+        '%', 'Usage:', '===', 'ERROR:', 'FAIL:', 'SUCCESS:', 'Validating',
+        'Database', '#include', '<', '>', 'std::', 'cout', 'endl',
+    ]
+    _CONST_SKIP_PATTERNS = ['%', 'Usage:', '===', 'ERROR:', 'FAIL:', 'SUCCESS:']
 
     def __init__(self, seed: int = 1337) -> None:
         self._rand = random.Random(seed)
@@ -34,6 +71,7 @@ class XORStringEncryptor:
             '_xor_decrypt',
             '_secure_free',
             '_init_encrypted_strings',
+            '_OBF_DECRYPT',
             '/* XOR String Decryption Helper */'
         ]
 
@@ -41,15 +79,26 @@ class XORStringEncryptor:
         found_markers = sum(1 for marker in markers if marker in source)
         return found_markers >= 2
 
-    def encrypt_strings(self, source: str) -> StringEncryptionResult:
+    def encrypt_strings(self, source: str, config: Optional[StringEncryptionConfiguration] = None) -> StringEncryptionResult:
         """
         Extract strings from C/C++ source and replace them with encrypted versions.
         Returns the transformed source code with decryption functions.
 
-        For const global strings, we use a two-phase approach:
-        1. Convert const globals to static non-const variables (initialized to NULL)
-        2. Generate a static constructor that initializes them with decrypted values
+        Emission mode is selected via StringEncryptionConfiguration:
+        - "heap" (default): malloc-based _xor_decrypt helper. Const globals use
+          a two-phase approach (NULL pointer + __attribute__((constructor)) init).
+        - "arena": same call-site shape as heap mode, but decrypted strings are
+          bump-allocated from one exactly-sized static arena (one allocation
+          instead of one per string), zeroized in one _secure_free_all.
+        - "constexpr": C++14 template helper decrypting into fixed-size static
+          buffers on first use - zero heap allocations at startup.
         """
+        mode = config.mode if config else "heap"
+        lazy = config.lazy if config else False
+        simd = config.simd if config else False
+        packed = (config.packed_table if config else False) and mode != "constexpr"
+        dedup = config.deduplicate if config else True
+
         # Check if file has already been string-encrypted
         if self._is_already_encrypted(source):
             self.logger.warning("Source code has already been string-encrypted. Skipping to avoid duplicate helper functions.")
@@ -63,11 +112,13 @@ class XORStringEncryptor:
                 transformed_source=source,
             )
 
-        # First, find const global string declarations
-        const_globals = self._extract_const_globals(source)
+        # Interning map shared across both literal classes: identical
+        # literals get one key and one ciphertext instead of one per site.
+        intern: Optional[Dict[str, Dict]] = {} if dedup else None
 
-        # Then find regular strings (in function bodies)
-        strings_info = self._extract_strings_with_positions(source)
+        # Single lexer pass: const global declarations and inline candidates
+        # come out of the same token sweep.
+        const_globals, strings_info = self._scan(source, intern)
 
         total_strings = len(const_globals) + len(strings_info)
 
@@ -81,21 +132,50 @@ class XORStringEncryptor:
                 transformed_source=source,
             )
 
-        # Generate decryption helper function
-        decryptor_code = self._generate_decryptor()
-
-        # Transform source by replacing strings with encrypted versions
-        transformed_source = self._transform_source(source, strings_info)
+        all_infos = list(const_globals) + strings_info
+
+        # Assign packed-table slots. With dedup, identical literals share one
+        # slot, so duplicates cost nothing in the blob and - thanks to the
+        # memoized _obf_str - are decrypted into one shared instance.
+        table_infos: List[Dict] = []
+        if packed:
+            slot_by_text: Dict[str, int] = {}
+            for info in all_infos:
+                text = info['text']
+                if dedup and text in slot_by_text:
+                    info['index'] = slot_by_text[text]
+                    continue
+                slot_by_text[text] = len(table_infos)
+                info['index'] = slot_by_text[text]
+                table_infos.append(info)
 
-        # Transform const globals (more complex transformation)
+        # Generate decryption helper function
+        if mode == "constexpr":
+            decryptor_code = self._generate_constexpr_decryptor()
+        elif mode == "arena":
+            # The encryptor knows every string length at transform time, so the
+            # arena can be sized exactly (lengths plus one NUL terminator each).
+            # Packed-table entries are memoized, so each unique slot decrypts
+            # only once; without the table every site decrypts independently.
+            sized_infos = table_infos if packed else all_infos
+            arena_bytes = sum(info['length'] + 1 for info in sized_infos)
+            decryptor_code = self._generate_arena_decryptor(arena_bytes, simd)
+        else:
+            decryptor_code = self._generate_decryptor(simd)
+
+        if packed:
+            # One contiguous blob + index table; call sites go through
+            # _obf_str(index) instead of per-site compound literals.
+            decryptor_code += self._generate_packed_table(table_infos)
+
+        # Collect every rewrite as an offset edit, then splice once.
+        edits: List[Tuple[int, int, str]] = []
+        edits.extend(self._inline_edits(source, strings_info, const_globals, mode, lazy, packed))
         if const_globals:
-            transformed_source = self._transform_const_globals(transformed_source, const_globals)
-        
-        # Fix const char* declarations that now have function calls as initializers
-        transformed_source = self._fix_const_declarations(transformed_source)
-
-        # Add decryptor at the beginning (after includes)
-        transformed_source = self._inject_decryptor(transformed_source, decryptor_code)
+            edits.extend(self._const_global_edits(source, const_globals, strings_info, mode, lazy, packed))
+        inject_at = self._injection_offset(source)
+        edits.append((inject_at, inject_at, decryptor_code + '\n'))
+        transformed_source = self._apply_edits(source, edits)
 
         encrypted_count = len(const_globals) + len(strings_info)
         percentage = (encrypted_count / total_strings * 100.0) if total_strings > 0 else 0.0
@@ -113,141 +193,236 @@ class XORStringEncryptor:
         return StringEncryptionResult(
             total_strings=total_strings,
             encrypted_strings=encrypted_count,
-            encryption_method="xor-rolling-key",
+            encryption_method="xor-constexpr" if mode == "constexpr" else "xor-rolling-key",
             encryption_percentage=round(percentage, 2),
             metadata=metadata,
             transformed_source=transformed_source,
         )
 
-    def _is_const_global_initializer(self, source: str, string_pos: int) -> bool:
-        """Check if a string at position string_pos is part of a const global initializer."""
-        # Look backward from string position to find context
-        # Pattern: const char* IDENTIFIER = "string"
-
-        # Find the line containing this string
-        line_start = source.rfind('\n', 0, string_pos) + 1
-        line_end = source.find('\n', string_pos)
-        if line_end == -1:
-            line_end = len(source)
-
-        line = source[line_start:line_end].strip()
-
-        # Check if line contains 'const' keyword
-        if 'const' not in line:
-            return False
+    def _encrypt_text(self, text: str, intern: Optional[Dict[str, Dict]] = None) -> Dict:
+        """Encrypt one literal, reusing the interned key/ciphertext for
+        duplicates so identical strings share one encrypted entry."""
+        if intern is not None and text in intern:
+            return intern[text]
+        key = self._rand.randint(1, 255)
+        encrypted_bytes = [ord(ch) ^ key for ch in text]
+        entry = {
+            'key': key,
+            'encrypted_hex': ','.join([f'0x{b:02x}' for b in encrypted_bytes]),
+        }
+        if intern is not None:
+            intern[text] = entry
+        return entry
+
+    def _scan(self, source: str, intern: Optional[Dict[str, Dict]] = None) -> Tuple[List[Dict], List[Dict]]:
+        """Tokenize the source once, classifying every string literal in context.
+
+        The master regex yields comments, char literals, raw strings, ordinary
+        strings, braces, and newlines in document order; brace depth and line
+        offsets are maintained as the sweep advances. Literals inside comments,
+        raw strings, char literals, or preprocessor lines are recognized and
+        excluded here instead of being mangled by later passes.
+
+        Returns (const_globals, strings_info) with the entry shapes the
+        transform edits and report metadata expect.
+        """
+        const_globals: List[Dict] = []
+        strings_info: List[Dict] = []
 
-        # Check if it's at global scope (not indented inside a function)
-        # Look backward to see if we're inside braces
+        line_num = 0
+        line_start = 0
         brace_depth = 0
-        for i in range(string_pos - 1, -1, -1):
-            if source[i] == '}':
+        n = len(source)
+
+        line_end_memo: Dict[int, int] = {}
+        pp_memo: Dict[int, bool] = {}
+        const_checked: Dict[int, bool] = {}
+
+        def line_end(ls: int) -> int:
+            end = line_end_memo.get(ls)
+            if end is None:
+                nl = source.find('\n', ls)
+                end = n if nl == -1 else nl
+                line_end_memo[ls] = end
+            return end
+
+        def is_preprocessor(ls: int) -> bool:
+            flag = pp_memo.get(ls)
+            if flag is None:
+                flag = source[ls:line_end(ls)].lstrip().startswith('#')
+                pp_memo[ls] = flag
+            return flag
+
+        for match in self._TOKEN_RE.finditer(source):
+            token = match.group(0)
+            first = token[0]
+
+            if first == '{':
                 brace_depth += 1
-            elif source[i] == '{':
+            elif first == '}':
                 brace_depth -= 1
-                # If we hit a '{' while depth is 0, we were at global scope
-                if brace_depth < 0:
-                    # Check if this is a function or struct/enum
-                    # Look backward to find what this brace belongs to
-                    before_brace = source[max(0, i-200):i].strip()
-                    # If we find a ')' before the '{', it's likely a function
-                    if ')' in before_brace:
-                        return False  # Inside a function, not global
-                    break
-
-        # If we're here and brace_depth is 0 or negative, we're at global scope
-        # and line contains 'const', so it's a const global initializer
-        return brace_depth <= 0 and 'const' in line
-
-    def _extract_candidate_strings(self, source: str) -> List[str]:
-        candidates: List[str] = []
-        current = []
-        in_string = False
-        escape = False
-        for char in source:
-            if in_string:
-                if escape:
-                    current.append(char)
-                    escape = False
-                elif char == "\\":
-                    escape = True
-                elif char == "\"":
-                    in_string = False
-                    if len(current) >= 3:
-                        candidates.append("".join(current))
-                    current = []
-                else:
-                    current.append(char)
-            elif char == "\"":
-                in_string = True
-        return candidates
+            elif first == '"':
+                # Unprefixed ordinary string literal; prefixed (u8/L/...) and
+                # raw literals start with their prefix character and are left
+                # untouched, as are literals inside comments or char literals.
+                if not is_preprocessor(line_start):
+                    self._classify_literal(
+                        source, match.start(), match.end(), token[1:-1],
+                        line_num, line_start, line_end(line_start), brace_depth,
+                        const_checked, const_globals, strings_info, intern,
+                    )
+
+            # Keep line bookkeeping right across multi-line tokens (block
+            # comments, raw strings) and plain newlines alike.
+            newlines = token.count('\n')
+            if newlines:
+                line_num += newlines
+                line_start = match.start() + token.rfind('\n') + 1
+
+        return const_globals, strings_info
+
+    def _classify_literal(
+        self,
+        source: str,
+        start: int,
+        end: int,
+        text: str,
+        line_num: int,
+        line_start: int,
+        line_end: int,
+        brace_depth: int,
+        const_checked: Dict[int, bool],
+        const_globals: List[Dict],
+        strings_info: List[Dict],
+        intern: Optional[Dict[str, Dict]],
+    ) -> None:
+        """Decide whether one string literal becomes a const-global entry, an
+        inline entry, or is left alone."""
+        line = source[line_start:line_end]
+
+        # Const global declaration? Check the single enclosing line, once.
+        if brace_depth == 0 and line_start not in const_checked:
+            const_checked[line_start] = True
+            match = self._CONST_C_RE.match(line)
+            is_cpp_string = False
+            if not match:
+                match = self._CONST_CPP_RE.match(line)
+                is_cpp_string = True
+            if match:
+                string_value = match.group(3)
+                # Skip format strings and UI strings
+                if any(pat in string_value for pat in self._CONST_SKIP_PATTERNS):
+                    return
+                entry = self._encrypt_text(string_value, intern)
+                const_globals.append({
+                    'line_num': line_num,
+                    'line_start': line_start,
+                    'line_end': line_end,
+                    'var_name': match.group(2),
+                    'text': string_value,
+                    'key': entry['key'],
+                    'length': len(string_value),
+                    'encrypted_hex': entry['encrypted_hex'],
+                    'static_prefix': match.group(1) or "",
+                    'original_line': line,
+                    'type': 'const_global',
+                    'is_cpp_string': is_cpp_string,  # Track if it's C++ std::string
+                })
+                return
+
+        # A const declaration at global scope that didn't match the patterns
+        # (or whose value is skipped) is never encrypted inline either.
+        if brace_depth == 0 and 'const' in line:
+            return
+
+        should_encrypt = (
+            len(text) > 2 and
+            not any(pat in text for pat in self._INLINE_SKIP_PATTERNS) and
+            not text.startswith(' ') and  # Skip indented strings (likely UI)
+            not text.startswith('#') and  # Skip preprocessor directives
+            not text.startswith('<') and  # Skip system headers
+            not text.startswith('std::') and  # Skip standard library references
+            text.replace('!', '').replace('.', '').replace(',', '').replace(' ', '').isalnum()  # Only encrypt simple alphanumeric secrets
+        )
+        if not should_encrypt:
+            return
+
+        entry = self._encrypt_text(text, intern)
+        strings_info.append({
+            'start': start,
+            'end': end,
+            'text': text,
+            'key': entry['key'],
+            'length': len(text),
+            'encrypted_hex': entry['encrypted_hex'],
+            'line_start': line_start,
+            'line_end': line_end,
+        })
+
+    def _generate_simd_kernel(self) -> str:
+        """Generate the vectorized XOR kernel shared by heap and arena modes.
+
+        Processes 32 bytes per iteration with AVX2, 16 with SSE2/NEON, with a
+        scalar tail and a full scalar fallback for other targets. The single
+        per-string key broadcasts into one vector register, so the loop body
+        stays branch-free.
+        """
+        return '''
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+static void _xor_block(char* dst, const unsigned char* enc, int len, unsigned char key) {
+    int i = 0;
+#if defined(__AVX2__)
+    __m256i k = _mm256_set1_epi8((char)key);
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(enc + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(v, k));
+    }
+#elif defined(__SSE2__)
+    __m128i k = _mm_set1_epi8((char)key);
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(enc + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(v, k));
+    }
+#elif defined(__ARM_NEON)
+    uint8x16_t k = vdupq_n_u8(key);
+    for (; i + 16 <= len; i += 16) {
+        vst1q_u8((uint8_t*)(dst + i), veorq_u8(vld1q_u8(enc + i), k));
+    }
+#endif
+    for (; i < len; i++) {
+        dst[i] = enc[i] ^ key;
+    }
+}
+'''
 
-    def _xor_string(self, text: str) -> str:
-        key = self._rand.randint(1, 255)
-        encrypted = [chr(ord(ch) ^ key) for ch in text]
-        return "".join(encrypted)
-
-    def _extract_strings_with_positions(self, source: str) -> List[Dict]:
-        """Extract string literals with their positions and encrypt them."""
-        strings_info = []
-        i = 0
-        while i < len(source):
-            if source[i] == '"':
-                start = i
-                i += 1
-                string_content = []
-                escaped = False
-
-                while i < len(source):
-                    if escaped:
-                        string_content.append(source[i])
-                        escaped = False
-                    elif source[i] == '\\':
-                        string_content.append(source[i])
-                        escaped = True
-                    elif source[i] == '"':
-                        end = i + 1
-                        text = ''.join(string_content)
-
-                        # Skip format strings, usage messages, single-char strings, and strings used in printf contexts
-                        # Also skip if string contains format specifiers or seems like output text
-                        skip_patterns = ['%', 'Usage:', '===', 'ERROR:', 'FAIL:', 'SUCCESS:', 'Validating', 'Database', '#include', '<', '>', 'std::', 'cout', 'endl']
-
-                        # Check if this string is part of a global const declaration
-                        is_const_global = self._is_const_global_initializer(source, start)
-                        should_encrypt = (
-                            len(text) > 2 and
-                            not any(pat in text for pat in skip_patterns) and
-                            not text.startswith(' ') and  # Skip indented strings (likely UI)
-                            not text.startswith('#') and  # Skip preprocessor directives
-                            not text.startswith('<') and  # Skip system headers
-                            not text.startswith('std::') and  # Skip standard library references
-                            text.replace('!', '').replace('.', '').replace(',', '').replace(' ', '').isalnum() and  # Only encrypt simple alphanumeric secrets
-                            not is_const_global  # Don't encrypt const global initializers
-                        )
-
-                        if should_encrypt:
-                            key = self._rand.randint(1, 255)
-                            encrypted_bytes = [ord(ch) ^ key for ch in text]
-                            encrypted_hex = ','.join([f'0x{b:02x}' for b in encrypted_bytes])
-
-                            strings_info.append({
-                                'start': start,
-                                'end': end,
-                                'text': text,
-                                'key': key,
-                                'length': len(text),
-                                'encrypted_hex': encrypted_hex,
-                            })
-                        break
-                    else:
-                        string_content.append(source[i])
-                    i += 1
-            i += 1
-
-        return strings_info
-
-    def _generate_decryptor(self) -> str:
+    def _generate_decryptor(self, simd: bool = False) -> str:
         """Generate C code for XOR decryption function."""
+        if simd:
+            return '''
+#include <stdlib.h>
+#include <string.h>
+''' + self._generate_simd_kernel() + '''
+/* XOR String Decryption Helper */
+static char* _xor_decrypt(const unsigned char* enc, int len, unsigned char key) {
+    char* dec = (char*)malloc(len + 1);
+    if (!dec) return NULL;
+    _xor_block(dec, enc, len, key);
+    dec[len] = '\\0';
+    return dec;
+}
+
+static void _secure_free(char* ptr) {
+    if (ptr) {
+        memset(ptr, 0, strlen(ptr));
+        free(ptr);
+    }
+}
+'''
         return '''
 #include <stdlib.h>
 #include <string.h>
@@ -271,143 +446,211 @@ static void _secure_free(char* ptr) {
 }
 '''
 
-    def _transform_source(self, source: str, strings_info: List[Dict]) -> str:
-        """Replace string literals with decryption calls."""
-        # Sort by position (reverse order to not mess up indices)
-        sorted_strings = sorted(strings_info, key=lambda x: x['start'], reverse=True)
-
-        transformed = source
-        for info in sorted_strings:
-            start = info['start']
-            end = info['end']
-            encrypted_hex = info['encrypted_hex']
-            key = info['key']
-            length = info['length']
-
-            # Simple replacement - just replace the string literal with the function call
-            replacement = f'_xor_decrypt((const unsigned char[]){{{encrypted_hex}}}, {length}, 0x{key:02x})'
-            transformed = transformed[:start] + replacement + transformed[end:]
-
-        return transformed
-
-    def _fix_const_declarations(self, source: str) -> str:
-        """Fix const char* declarations that have function calls as initializers."""
-        lines = source.split('\n')
-        fixed_lines = []
-        
-        for i, line in enumerate(lines):
-            # Check if this line has a const char* declaration with _xor_decrypt call
-            if 'const char*' in line and '_xor_decrypt' in line:
-                # Extract variable name
-                var_match = re.search(r'const char\*\s+(\w+)\s*=', line)
-                if var_match:
-                    var_name = var_match.group(1)
-                    # Replace with non-const declaration
-                    new_line = f"char* {var_name};"
-                    fixed_lines.append(new_line)
-                    
-                    # Add initialization on next line
-                    init_line = f"    {var_name} = {line.split('=', 1)[1].strip()};"
-                    fixed_lines.append(init_line)
-                else:
-                    fixed_lines.append(line)
-            else:
-                fixed_lines.append(line)
-        
-        return '\n'.join(fixed_lines)
-
-    def _inject_decryptor(self, source: str, decryptor_code: str) -> str:
-        """Inject decryption function after includes and initial comments."""
-        lines = source.split('\n')
-        insert_pos = 0
-        in_block_comment = False
-
-        for i, line in enumerate(lines):
-            stripped = line.strip()
+    def _generate_arena_decryptor(self, arena_bytes: int, simd: bool = False) -> str:
+        """Generate C code that decrypts into a single static arena.
 
-            # Track block comments
-            if '/*' in stripped:
-                in_block_comment = True
-            if '*/' in stripped:
-                in_block_comment = False
-                continue
-
-            # Skip if we're in a block comment or line comment
-            if in_block_comment or stripped.startswith('//'):
-                continue
-
-            # Found an #include - update position
-            if stripped.startswith('#include'):
-                insert_pos = i + 1
-
-            # Found first non-comment code line - stop searching
-            elif stripped and not stripped.startswith('#'):
-                if insert_pos == 0:
-                    insert_pos = i
-                break
-
-        lines.insert(insert_pos, decryptor_code)
-        return '\n'.join(lines)
+        One bump-allocated arena replaces the per-string malloc round-trips at
+        startup and keeps all decrypted literals on contiguous cache lines.
+        If the arena is ever exhausted (e.g. an inline site re-evaluated in a
+        loop), we fall back to malloc rather than failing the program.
+        """
+        kernel = self._generate_simd_kernel() if simd else ""
+        decrypt_loop = (
+            "    _xor_block(dec, enc, len, key);"
+            if simd
+            else "    for (int i = 0; i < len; i++) {\n        dec[i] = enc[i] ^ key;\n    }"
+        )
+        return f'''
+#include <stdlib.h>
+#include <string.h>
+{kernel}
+/* XOR String Decryption Helper */
+static char _obf_arena[{arena_bytes}];
+static unsigned int _obf_arena_used = 0;
+
+static char* _xor_decrypt(const unsigned char* enc, int len, unsigned char key) {{
+    char* dec;
+    if (_obf_arena_used + (unsigned int)len + 1 <= sizeof(_obf_arena)) {{
+        dec = _obf_arena + _obf_arena_used;
+        _obf_arena_used += (unsigned int)len + 1;
+    }} else {{
+        dec = (char*)malloc(len + 1);
+        if (!dec) return NULL;
+    }}
+{decrypt_loop}
+    dec[len] = '\\0';
+    return dec;
+}}
 
-    def _extract_const_globals(self, source: str) -> List[Dict]:
-        """Extract const global string declarations like: const char* NAME = "value"; """
-        import re
+static void _secure_free_all(void) {{
+    memset(_obf_arena, 0, sizeof(_obf_arena));
+    _obf_arena_used = 0;
+}}
+'''
 
-        const_globals = []
+    def _generate_constexpr_decryptor(self) -> str:
+        """Generate C++14 template-based decryption helper (zero heap traffic).
 
-        # Pattern 1: C-style - const char* IDENTIFIER = "string";
-        # Also matches: static const char* or const char *
-        c_pattern = r'^\s*(static\s+)?const\s+char\s*\*\s+(\w+)\s*=\s*"([^"]+)"\s*;'
+        Encrypted bytes live in a constexpr array; decryption happens on first
+        use into a fixed-size static buffer inside the _OBF_DECRYPT lambda, so
+        there is no malloc and no static-constructor work for unused strings.
+        """
+        return '''
+#include <cstddef>
 
-        # Pattern 2: C++ style - const std::string IDENTIFIER = "string";
-        cpp_pattern = r'^\s*(static\s+)?const\s+std::string\s+(\w+)\s*=\s*"([^"]+)"\s*;'
+/* XOR String Decryption Helper */
+namespace _obf {
+template <std::size_t N>
+struct xor_string {
+    char plain[N + 1];
+    xor_string(const unsigned char (&enc)[N], unsigned char key) {
+        for (std::size_t i = 0; i < N; ++i)
+            plain[i] = static_cast<char>(enc[i] ^ key);
+        plain[N] = '\\0';
+    }
+    const char* c_str() const { return plain; }
+};
+}
 
-        lines = source.split('\n')
-        for line_num, line in enumerate(lines):
-            # Try C pattern first
-            match = re.match(c_pattern, line)
-            is_cpp_string = False
+#define _OBF_DECRYPT(key, ...)                                                     \\
+    ([]() -> const char* {                                                         \\
+        static constexpr unsigned char _obf_enc[] = {__VA_ARGS__};                 \\
+        static const _obf::xor_string<sizeof(_obf_enc)> _obf_dec(_obf_enc, (key)); \\
+        return _obf_dec.c_str();                                                   \\
+    }())
+'''
 
-            # If no C match, try C++ pattern
-            if not match:
-                match = re.match(cpp_pattern, line)
-                is_cpp_string = True
+    def _generate_packed_table(self, all_infos: List[Dict]) -> str:
+        """Generate one packed .rodata blob plus an offset/length/key table.
 
-            if match:
-                static_prefix = match.group(1) or ""
-                var_name = match.group(2)
-                string_value = match.group(3)
+        Replaces the per-call-site compound literals: all encrypted bytes live
+        contiguously in _obf_blob, and _obf_tab maps a string index to its
+        slice and key. The eager-init loop becomes a single linear sweep over
+        contiguous memory, and per-string static-data overhead disappears.
+        """
+        blob_bytes: List[str] = []
+        table_rows: List[str] = []
+        offset = 0
+        for info in all_infos:
+            blob_bytes.append(info['encrypted_hex'])
+            table_rows.append(f"    {{{offset}u, {info['length']}u, 0x{info['key']:02x}}},")
+            offset += info['length']
+
+        blob = ',\n    '.join(blob_bytes)
+        table = '\n'.join(table_rows)
+        count = len(all_infos)
+        return f'''
+/* Packed encrypted string table */
+static const unsigned char _obf_blob[] = {{
+    {blob}
+}};
+
+static const struct {{ unsigned int off; unsigned int len; unsigned char key; }} _obf_tab[] = {{
+{table}
+}};
+
+/* Memoized per slot: a literal interned across many sites decrypts once. */
+static char* _obf_ptrs[{count}];
+
+static char* _obf_str(int idx) {{
+    if (!_obf_ptrs[idx]) {{
+        _obf_ptrs[idx] = _xor_decrypt(_obf_blob + _obf_tab[idx].off, (int)_obf_tab[idx].len, _obf_tab[idx].key);
+    }}
+    return _obf_ptrs[idx];
+}}
+'''
 
-                # Skip format strings and UI strings
-                skip_patterns = ['%', 'Usage:', '===', 'ERROR:', 'FAIL:', 'SUCCESS:']
-                if any(pat in string_value for pat in skip_patterns):
-                    continue
+    def _decrypt_call(self, info: Dict, packed: bool) -> str:
+        """Build the decryption expression for one string (heap/arena modes)."""
+        if packed:
+            return f"_obf_str({info['index']})"
+        return (
+            f"_xor_decrypt((const unsigned char[]){{{info['encrypted_hex']}}}, "
+            f"{info['length']}, 0x{info['key']:02x})"
+        )
 
-                # Encrypt this string
-                key = self._rand.randint(1, 255)
-                encrypted_bytes = [ord(ch) ^ key for ch in string_value]
-                encrypted_hex = ','.join([f'0x{b:02x}' for b in encrypted_bytes])
+    def _replacement_expr(self, info: Dict, mode: str, packed: bool) -> str:
+        if mode == "constexpr":
+            return f"_OBF_DECRYPT(0x{info['key']:02x}, {info['encrypted_hex']})"
+        return self._decrypt_call(info, packed)
+
+    def _lazy_use_pattern(self, const_globals: List[Dict]) -> Optional[re.Pattern]:
+        """One alternation over every lazy global name, so use-site rewriting
+        is a single sweep instead of one pass per variable."""
+        if not const_globals:
+            return None
+        names = '|'.join(re.escape(info['var_name']) for info in const_globals)
+        return re.compile(r'\b(' + names + r')\b')
+
+    def _inline_edits(
+        self,
+        source: str,
+        strings_info: List[Dict],
+        const_globals: List[Dict],
+        mode: str,
+        lazy: bool,
+        packed: bool,
+    ) -> List[Tuple[int, int, str]]:
+        """Edits replacing inline string literals with decryption calls.
+
+        Local `const char* x = "...";` declarations cannot keep a non-const
+        decrypt call as initializer (heap/arena modes return char*), so the
+        whole line is rewritten to a mutable declaration plus a separate
+        assignment instead of a plain literal replacement.
+        """
+        edits: List[Tuple[int, int, str]] = []
+        use_pattern = self._lazy_use_pattern(const_globals) if lazy else None
+
+        by_line: Dict[int, List[Dict]] = {}
+        for info in strings_info:
+            by_line.setdefault(info['line_start'], []).append(info)
+
+        for line_start, infos in by_line.items():
+            line_end = infos[0]['line_end']
+            line = source[line_start:line_end]
+            decl_match = None
+            if mode != "constexpr" and 'const char*' in line:
+                decl_match = self._LOCAL_CONST_RE.search(line)
+
+            if decl_match is None:
+                for info in infos:
+                    edits.append((info['start'], info['end'], self._replacement_expr(info, mode, packed)))
+                continue
 
-                const_globals.append({
-                    'line_num': line_num,
-                    'var_name': var_name,
-                    'text': string_value,
-                    'key': key,
-                    'length': len(string_value),
-                    'encrypted_hex': encrypted_hex,
-                    'static_prefix': static_prefix,
-                    'original_line': line,
-                    'type': 'const_global',
-                    'is_cpp_string': is_cpp_string,  # Track if it's C++ std::string
-                })
+            # Rebuild just this line with its replacements applied, then split
+            # declaration and initialization.
+            for info in sorted(infos, key=lambda x: x['start'], reverse=True):
+                rel_start = info['start'] - line_start
+                rel_end = info['end'] - line_start
+                line = line[:rel_start] + self._replacement_expr(info, mode, packed) + line[rel_end:]
+            var_name = decl_match.group(1)
+            tail = line.split('=', 1)[1].strip()
+            if use_pattern is not None:
+                tail = use_pattern.sub(lambda m: f"_obf_get_{m.group(1)}()", tail)
+            edits.append((line_start, line_end, f"char* {var_name};\n    {var_name} = {tail};"))
+
+        return edits
+
+    def _const_global_edits(
+        self,
+        source: str,
+        const_globals: List[Dict],
+        strings_info: List[Dict],
+        mode: str,
+        lazy: bool,
+        packed: bool,
+    ) -> List[Tuple[int, int, str]]:
+        """
+        Edits transforming const global declarations to use encrypted strings.
 
-        return const_globals
+        Constexpr mode: replace the initializer in place with an _OBF_DECRYPT
+        call; the declaration stays const and no static constructor is needed.
 
-    def _transform_const_globals(self, source: str, const_globals: List[Dict]) -> str:
-        """
-        Transform const global declarations to use encrypted strings.
+        Lazy mode (heap/arena): each global becomes a generated accessor with a
+        per-string once-flag, and every use site is rewritten to call it, so
+        decryption cost is paid only for strings actually touched.
 
-        Strategy:
+        Heap mode strategy:
         1. Replace const declarations with static variables initialized to NULL/""
         2. Generate a static constructor function that initializes them
         3. Use __attribute__((constructor)) to run before main()
@@ -415,21 +658,32 @@ static void _secure_free(char* ptr) {
         For C++ std::string: Keep as std::string but initialize empty
         For C char*: Change to char* initialized to NULL
         """
-        lines = source.split('\n')
+        edits: List[Tuple[int, int, str]] = []
+
+        if mode == "constexpr":
+            # In-place initializer replacement - keeps declarations const and
+            # avoids the eager __attribute__((constructor)) init entirely.
+            for info in const_globals:
+                decrypt_call = f"_OBF_DECRYPT(0x{info['key']:02x}, {info['encrypted_hex']})"
+                if info.get('is_cpp_string', False):
+                    new_line = f"{info['static_prefix']}const std::string {info['var_name']} = {decrypt_call};"
+                else:
+                    new_line = f"{info['static_prefix']}const char* {info['var_name']} = {decrypt_call};"
+                edits.append((info['line_start'], info['line_end'], new_line))
+            return edits
+
+        if lazy:
+            return self._lazy_const_global_edits(source, const_globals, strings_info, packed)
 
         # Step 1: Replace const declarations
         for info in const_globals:
-            line_num = info['line_num']
-            var_name = info['var_name']
-            static_prefix = info['static_prefix']
-            is_cpp_string = info.get('is_cpp_string', False)
-
-            if is_cpp_string:
+            if info.get('is_cpp_string', False):
                 # For C++ std::string: std::string VAR_NAME = "";
-                lines[line_num] = f"{static_prefix}std::string {var_name} = \"\";"
+                new_line = f"{info['static_prefix']}std::string {info['var_name']} = \"\";"
             else:
                 # For C char*: char* VAR_NAME = NULL;
-                lines[line_num] = f"{static_prefix}char* {var_name} = NULL;"
+                new_line = f"{info['static_prefix']}char* {info['var_name']} = NULL;"
+            edits.append((info['line_start'], info['line_end'], new_line))
 
         # Step 2: Generate initialization function
         init_lines = [
@@ -439,64 +693,210 @@ static void _secure_free(char* ptr) {
         ]
 
         for info in const_globals:
-            var_name = info['var_name']
-            encrypted_hex = info['encrypted_hex']
-            length = info['length']
-            key = info['key']
-            is_cpp_string = info.get('is_cpp_string', False)
-
-            if is_cpp_string:
+            decrypt_call = self._decrypt_call(info, packed)
+            if info.get('is_cpp_string', False):
                 # For C++ std::string, assign decrypted char* to std::string (implicit conversion)
-                init_lines.append(
-                    f"    {var_name} = std::string(_xor_decrypt((const unsigned char[]){{{encrypted_hex}}}, {length}, 0x{key:02x}));"
-                )
+                init_lines.append(f"    {info['var_name']} = std::string({decrypt_call});")
             else:
                 # For C char*, direct assignment
-                init_lines.append(
-                    f"    {var_name} = _xor_decrypt((const unsigned char[]){{{encrypted_hex}}}, {length}, 0x{key:02x});"
-                )
+                init_lines.append(f"    {info['var_name']} = {decrypt_call};")
 
         init_lines.append("}")
         init_lines.append("")
 
-        # Step 3: Find where to inject the init function (after global variables, before first function)
-        # Strategy: Find the first function definition (has return type, name, params, and opening brace)
-        inject_pos = len(lines)
+        # Step 3: Inject the init function after the globals, before the first
+        # function definition.
+        inject_at = self._init_injection_offset(source, {info['line_start'] for info in const_globals})
+        init_text = '\n'.join(init_lines)
+        if inject_at >= len(source):
+            edits.append((len(source), len(source), '\n' + init_text))
+        else:
+            edits.append((inject_at, inject_at, init_text + '\n'))
+
+        return edits
+
+    def _lazy_const_global_edits(
+        self,
+        source: str,
+        const_globals: List[Dict],
+        strings_info: List[Dict],
+        packed: bool = False,
+    ) -> List[Tuple[int, int, str]]:
+        """
+        Lazy variant of the const-global transformation.
+
+        Each declaration is replaced by an accessor function guarded by a
+        per-string once-flag, and all other references to the variable are
+        rewritten to accessor calls. Nothing is decrypted at load time.
+        """
+        edits: List[Tuple[int, int, str]] = []
+
+        # Spans the inline pass already rewrites (encrypted literals and split
+        # const char* lines, which apply the accessor rewrite themselves) plus
+        # the declarations replaced below.
+        skip_spans = sorted(
+            [(info['line_start'], info['line_end']) for info in const_globals]
+            + [
+                (info['line_start'], info['line_end'])
+                for info in strings_info
+                if 'const char*' in source[info['line_start']:info['line_end']]
+            ]
+            + [(info['start'], info['end']) for info in strings_info]
+        )
+
+        def in_skip_span(pos: int) -> bool:
+            for span_start, span_end in skip_spans:
+                if span_start <= pos < span_end:
+                    return True
+                if span_start > pos:
+                    break
+            return False
+
+        # Step 1: Rewrite use sites in one sweep over the source.
+        use_pattern = self._lazy_use_pattern(const_globals)
+        for match in use_pattern.finditer(source):
+            if in_skip_span(match.start()):
+                continue
+            edits.append((match.start(), match.end(), f"_obf_get_{match.group(1)}()"))
+
+        # Step 2: Replace each declaration with its accessor.
+        for info in const_globals:
+            var_name = info['var_name']
+            decrypt_call = self._decrypt_call(info, packed)
+
+            if info.get('is_cpp_string', False):
+                # Magic statics make the first-use initialization thread-safe.
+                accessor = (
+                    f"static const std::string& _obf_get_{var_name}(void) {{\n"
+                    f"    static const std::string _obf_val({decrypt_call});\n"
+                    f"    return _obf_val;\n"
+                    f"}}"
+                )
+            else:
+                # Plain once-flag; matches the single-threaded init the eager
+                # static constructor provided.
+                accessor = (
+                    f"static char* _obf_get_{var_name}(void) {{\n"
+                    f"    static int _obf_once = 0;\n"
+                    f"    static char* _obf_val = NULL;\n"
+                    f"    if (!_obf_once) {{\n"
+                    f"        _obf_val = {decrypt_call};\n"
+                    f"        _obf_once = 1;\n"
+                    f"    }}\n"
+                    f"    return _obf_val;\n"
+                    f"}}"
+                )
+            edits.append((info['line_start'], info['line_end'], accessor))
+
+        return edits
+
+    def _injection_offset(self, source: str) -> int:
+        """Offset where the decryptor block is inserted (after includes and
+        initial comments). Only the file prologue is walked - the loop stops
+        at the first code line."""
+        insert_at = 0
         in_block_comment = False
-        found_globals = False
+        pos = 0
+        n = len(source)
 
-        for i, line in enumerate(lines):
-            stripped = line.strip()
+        while pos <= n:
+            nl = source.find('\n', pos)
+            end = n if nl == -1 else nl
+            stripped = source[pos:end].strip()
 
             # Track block comments
             if '/*' in stripped:
                 in_block_comment = True
             if '*/' in stripped:
                 in_block_comment = False
+                if nl == -1:
+                    break
+                pos = nl + 1
+                continue
+
+            # Skip if we're in a block comment or line comment
+            if not (in_block_comment or stripped.startswith('//')):
+                # Found an #include - update position
+                if stripped.startswith('#include'):
+                    insert_at = min(end + 1, n)
+                # Found first non-comment code line - stop searching
+                elif stripped and not stripped.startswith('#'):
+                    if insert_at == 0:
+                        insert_at = pos
+                    break
+
+            if nl == -1:
+                break
+            pos = nl + 1
+
+        return insert_at
+
+    def _init_injection_offset(self, source: str, decl_line_starts: set) -> int:
+        """Offset of the first function definition after the (rewritten)
+        globals - where the eager-init constructor goes. Falls back to the
+        end of the file when no function-like line is found."""
+        in_block_comment = False
+        found_globals = False
+        pos = 0
+        n = len(source)
+
+        while pos <= n:
+            nl = source.find('\n', pos)
+            end = n if nl == -1 else nl
+            stripped = source[pos:end].strip()
+
+            if '/*' in stripped:
+                in_block_comment = True
+            if '*/' in stripped:
+                in_block_comment = False
+                if nl == -1:
+                    break
+                pos = nl + 1
                 continue
 
-            # Skip if in block comment, line comment, or empty
             if in_block_comment or not stripped or stripped.startswith('//') or stripped.startswith('*'):
+                if nl == -1:
+                    break
+                pos = nl + 1
                 continue
 
-            # Track if we've found our global variables
-            if ('char* ' in stripped or 'std::string ' in stripped) and '= NULL' in stripped or '= "";' in stripped:
+            if pos in decl_line_starts:
                 found_globals = True
+                if nl == -1:
+                    break
+                pos = nl + 1
                 continue
 
-            # After finding globals, look for first function
+            # After the globals, look for the first function definition:
+            # int fname(...), void fname(...), etc.
             if found_globals:
-                # Look for function definitions: int fname(...) or void fname(...)
-                # Check if line has function signature pattern and next line (or same line) has {
                 if ('(' in stripped and ')' in stripped and
                     (stripped.startswith('int ') or stripped.startswith('void ') or
                      stripped.startswith('char') or stripped.startswith('static'))):
-                    # This is likely a function definition
-                    inject_pos = i
-                    break
+                    return pos
 
-        # Insert initialization function
-        for line in reversed(init_lines):
-            lines.insert(inject_pos, line)
+            if nl == -1:
+                break
+            pos = nl + 1
+
+        return n
+
+    @staticmethod
+    def _apply_edits(source: str, edits: List[Tuple[int, int, str]]) -> str:
+        """Apply all collected (start, end, text) edits in one splice.
 
-        return '\n'.join(lines)
+        Edits are sorted by offset; pure insertions (start == end) at the same
+        offset as a replacement land before it. Overlapping edits should not
+        occur by construction - if one slips through, the later edit is
+        dropped rather than corrupting offsets.
+        """
+        parts: List[str] = []
+        pos = 0
+        for start, end, text in sorted(edits, key=lambda e: (e[0], e[1])):
+            if start < pos:
+                continue
+            parts.append(source[pos:start])
+            parts.append(text)
+            pos = end
+        parts.append(source[pos:])
+        return ''.join(parts)
@@ -0,0 +1,172 @@
+"""
+Project-level symbol hash cache with consistent map merging.
+
+Per-TU symbol maps are correct in isolation, but a project of hundreds of
+translation units hashes every shared identifier once per TU and used to rely
+on external scripting to stitch the per-file maps into one link-consistent
+table. ProjectSymbolCache persists the identifier->obfuscated-name table
+across invocations: each TU's map is merged in without re-hashing, duplicate
+identifiers are verified to map to the same name, and the hashing parameters
+(algorithm, length, prefix style, salt) are fingerprinted so a run with a
+different salt fails fast instead of silently producing names that will not
+link against earlier objects.
+
+The salt itself is never persisted - only a digest of it - so the cache file
+can ship alongside the symbol maps without leaking the secret.
+"""
+
+from __future__ import annotations
+
+import hashlib
+import json
+import os
+import tempfile
+from pathlib import Path
+from typing import Dict, Optional
+
+from .exceptions import ObfuscationError
+from .utils import create_logger, ensure_directory
+
+CACHE_VERSION = 1
+
+
+def _salt_fingerprint(salt: Optional[str]) -> str:
+    return hashlib.sha256((salt or "").encode("utf-8")).hexdigest()[:16]
+
+
+class ProjectSymbolCache:
+    """Persistent identifier->obfuscated-name table shared across TUs."""
+
+    def __init__(self, cache_file: Path) -> None:
+        self.logger = create_logger(__name__)
+        self.cache_file = cache_file
+        self._params: Optional[Dict] = None
+        self._symbols: Dict[str, str] = {}
+        self._load()
+
+    def verify_params(
+        self,
+        algorithm: str,
+        hash_length: int,
+        prefix_style: str,
+        salt: Optional[str],
+    ) -> None:
+        """Pin the hashing parameters on first use; reject mismatches after.
+
+        Hashing with a different salt or length would produce names that do
+        not link against objects built from earlier TUs, so this raises
+        before any work is done rather than corrupting the table.
+        """
+        params = {
+            "algorithm": algorithm,
+            "hash_length": hash_length,
+            "prefix_style": prefix_style,
+            "salt_fingerprint": _salt_fingerprint(salt),
+        }
+        if self._params is None:
+            self._params = params
+            self._save()
+            return
+        if self._params != params:
+            raise ObfuscationError(
+                f"Symbol hashing parameters do not match project map {self.cache_file}: "
+                f"cached {self._params}, requested {params}. Use the same "
+                "algorithm/length/prefix/salt for every TU, or delete the map "
+                "to start a new project table."
+            )
+
+    def merge_map_file(self, map_path: Path) -> int:
+        """Merge one per-TU map into the project table without re-hashing.
+
+        Returns the number of newly added identifiers. A duplicate identifier
+        mapping to a different obfuscated name means the TU was hashed with
+        inconsistent parameters and is rejected.
+        """
+        if not map_path.exists():
+            return 0
+        try:
+            with open(map_path) as f:
+                map_data = json.load(f)
+        except (OSError, json.JSONDecodeError) as exc:
+            self.logger.warning(f"Could not read symbol map {map_path}: {exc}")
+            return 0
+
+        added = 0
+        for original, obfuscated in self._iter_mappings(map_data):
+            existing = self._symbols.get(original)
+            if existing is None:
+                self._symbols[original] = obfuscated
+                added += 1
+            elif existing != obfuscated:
+                raise ObfuscationError(
+                    f"Symbol map conflict for '{original}': project table has "
+                    f"'{existing}' but {map_path} has '{obfuscated}'. This "
+                    "usually means the TU was obfuscated with a different salt."
+                )
+        if added:
+            self._save()
+        return added
+
+    def lookup(self, identifier: str) -> Optional[str]:
+        return self._symbols.get(identifier)
+
+    @property
+    def symbols(self) -> Dict[str, str]:
+        return dict(self._symbols)
+
+    def stats(self) -> Dict:
+        return {
+            "cache_file": str(self.cache_file),
+            "total_symbols": len(self._symbols),
+            "params": self._params,
+        }
+
+    # Internal --------------------------------------------------------------
+
+    @staticmethod
+    def _iter_mappings(map_data: Dict):
+        """Yield (original, obfuscated) pairs from either map shape the tool
+        emits: a flat "symbols" list/dict, or split function/variable dicts."""
+        symbols = map_data.get("symbols")
+        if isinstance(symbols, dict):
+            yield from symbols.items()
+        elif isinstance(symbols, list):
+            for entry in symbols:
+                if isinstance(entry, dict):
+                    original = entry.get("original") or entry.get("name")
+                    obfuscated = entry.get("obfuscated") or entry.get("new_name")
+                    if original and obfuscated:
+                        yield original, obfuscated
+        for key in ("function_mappings", "variable_mappings"):
+            mappings = map_data.get(key)
+            if isinstance(mappings, dict):
+                yield from mappings.items()
+
+    def _load(self) -> None:
+        try:
+            with open(self.cache_file) as f:
+                data = json.load(f)
+            if data.get("version") == CACHE_VERSION:
+                self._params = data.get("params")
+                self._symbols = data.get("symbols", {})
+        except (OSError, json.JSONDecodeError):
+            pass
+
+    def _save(self) -> None:
+        """Atomic write: merges are deterministic, so concurrent batch
+        workers can only race to write identical entries, never corrupt."""
+        try:
+            ensure_directory(self.cache_file.parent)
+            fd, tmp_path = tempfile.mkstemp(
+                dir=str(self.cache_file.parent), prefix=".symbol-map-", suffix=".tmp"
+            )
+            with os.fdopen(fd, "w") as f:
+                json.dump(
+                    {"version": CACHE_VERSION, "params": self._params, "symbols": self._symbols},
+                    f,
+                    indent=2,
+                    sort_keys=True,
+                )
+            os.replace(tmp_path, self.cache_file)
+        except OSError as exc:  # pragma: no cover - cache is best-effort
+            self.logger.warning(f"Could not persist project symbol map: {exc}")
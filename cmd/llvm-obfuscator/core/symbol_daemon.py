@@ -0,0 +1,199 @@
+"""
+Persistent daemon client for the symbol-obfuscator tool.
+
+Spawning `symbol-obfuscate` once per translation unit re-initializes hashing,
+re-parses preserve lists, and re-reads the map file on every call; in batch
+runs over hundreds of TUs that spawn+init overhead dominates. This module
+keeps one long-lived `symbol-obfuscate --daemon` process per Python process
+and multiplexes requests over its stdin/stdout, so the tool's identifier->hash
+cache stays warm across files and identifiers shared via headers hash once per
+project instead of once per TU.
+
+Protocol (newline-delimited JSON, one object per line):
+- On startup with `--daemon` the tool emits a ready line:
+      {"event": "ready", "protocol": 1}
+- Each request is one line:
+      {"op": "obfuscate", "input": "...", "output": "...", "options": {...}}
+  answered by one line:
+      {"ok": true, "symbols_obfuscated": N}   or   {"ok": false, "error": "..."}
+- {"op": "shutdown"} asks the tool to exit cleanly.
+
+Availability is probed once: a missing binary, a binary without --daemon
+support, or a failed handshake all mark the daemon unavailable and callers
+fall back to the one-shot spawn path. A daemon that dies mid-run is restarted
+once; a second failure also falls back, so the daemon is strictly an
+optimization and never a new failure mode.
+"""
+
+from __future__ import annotations
+
+import atexit
+import json
+import select
+import subprocess
+import threading
+import time
+from pathlib import Path
+from typing import Dict, Optional
+
+from .exceptions import ObfuscationError
+from .utils import create_logger
+
+
+class SymbolDaemonError(ObfuscationError):
+    """Raised when the daemon is unusable; callers fall back to one-shot."""
+
+
+class SymbolObfuscationDaemon:
+    """One long-lived symbol-obfuscate process, shared across files."""
+
+    PROTOCOL_VERSION = 1
+
+    def __init__(
+        self,
+        tool_path: Path,
+        startup_timeout: float = 5.0,
+        request_timeout: float = 60.0,
+    ) -> None:
+        self.logger = create_logger(__name__)
+        self.tool_path = tool_path
+        self.startup_timeout = startup_timeout
+        self.request_timeout = request_timeout
+        self._lock = threading.Lock()
+        self._process: Optional[subprocess.Popen] = None
+        self._restarted = False
+        # None = not probed yet; False = unsupported, never retried.
+        self._available: Optional[bool] = None
+
+    def available(self) -> bool:
+        """Probe (once) whether the tool exists and speaks the daemon protocol."""
+        with self._lock:
+            if self._available is None:
+                self._available = self._start_locked()
+            return self._available
+
+    def request(self, payload: Dict) -> Dict:
+        """Send one request line and return the parsed response.
+
+        Raises SymbolDaemonError if the daemon is gone or misbehaves; the
+        daemon is restarted once per process before giving up for good.
+        """
+        with self._lock:
+            if not self._available or self._process is None:
+                raise SymbolDaemonError("Symbol daemon is not available")
+            try:
+                return self._roundtrip_locked(payload)
+            except SymbolDaemonError:
+                self._kill_locked()
+                if self._restarted:
+                    self._available = False
+                    raise
+                # One restart: a single crash (e.g. a pathological input)
+                # should not demote the whole batch to one-shot spawns.
+                self._restarted = True
+                self.logger.warning("Symbol daemon died; restarting once")
+                if not self._start_locked():
+                    self._available = False
+                    raise SymbolDaemonError("Symbol daemon restart failed")
+                return self._roundtrip_locked(payload)
+
+    def stop(self) -> None:
+        """Ask the daemon to exit; kill it if it does not comply."""
+        with self._lock:
+            if self._process is None:
+                return
+            try:
+                self._process.stdin.write(json.dumps({"op": "shutdown"}).encode() + b"\n")
+                self._process.stdin.flush()
+                self._process.wait(timeout=2)
+            except (OSError, ValueError, subprocess.TimeoutExpired):
+                pass
+            self._kill_locked()
+
+    # Internal --------------------------------------------------------------
+
+    def _start_locked(self) -> bool:
+        if not self.tool_path.exists():
+            return False
+        try:
+            self._process = subprocess.Popen(
+                [str(self.tool_path), "--daemon"],
+                stdin=subprocess.PIPE,
+                stdout=subprocess.PIPE,
+                stderr=subprocess.DEVNULL,
+            )
+        except OSError as exc:
+            self.logger.warning(f"Could not start symbol daemon: {exc}")
+            return False
+
+        # Handshake: older tool builds without --daemon print usage and exit,
+        # which fails JSON parsing here and falls back cleanly.
+        try:
+            ready = json.loads(self._read_line_locked(self.startup_timeout))
+        except (SymbolDaemonError, json.JSONDecodeError):
+            self.logger.info(
+                "symbol-obfuscate does not support --daemon; using one-shot spawns"
+            )
+            self._kill_locked()
+            return False
+
+        if ready.get("event") != "ready" or ready.get("protocol") != self.PROTOCOL_VERSION:
+            self.logger.warning(f"Unexpected symbol daemon handshake: {ready}")
+            self._kill_locked()
+            return False
+        return True
+
+    def _roundtrip_locked(self, payload: Dict) -> Dict:
+        try:
+            self._process.stdin.write(json.dumps(payload).encode() + b"\n")
+            self._process.stdin.flush()
+        except (OSError, ValueError) as exc:
+            raise SymbolDaemonError(f"Symbol daemon write failed: {exc}")
+        try:
+            return json.loads(self._read_line_locked(self.request_timeout))
+        except json.JSONDecodeError as exc:
+            raise SymbolDaemonError(f"Symbol daemon sent invalid JSON: {exc}")
+
+    def _read_line_locked(self, timeout: float) -> bytes:
+        """Read one newline-terminated response with a deadline."""
+        stdout = self._process.stdout
+        deadline = time.monotonic() + timeout
+        buf = bytearray()
+        while True:
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                raise SymbolDaemonError("Symbol daemon response timed out")
+            ready, _, _ = select.select([stdout], [], [], remaining)
+            if not ready:
+                raise SymbolDaemonError("Symbol daemon response timed out")
+            chunk = stdout.raw.read(4096)
+            if not chunk:
+                raise SymbolDaemonError("Symbol daemon closed its stdout")
+            buf.extend(chunk)
+            newline = buf.find(b"\n")
+            if newline != -1:
+                return bytes(buf[:newline])
+
+    def _kill_locked(self) -> None:
+        if self._process is None:
+            return
+        try:
+            self._process.kill()
+            self._process.wait(timeout=2)
+        except (OSError, subprocess.TimeoutExpired):
+            pass
+        self._process = None
+
+
+_daemon: Optional[SymbolObfuscationDaemon] = None
+_daemon_lock = threading.Lock()
+
+
+def get_symbol_daemon(tool_path: Path) -> SymbolObfuscationDaemon:
+    """Process-wide daemon so every SymbolObfuscator shares one warm cache."""
+    global _daemon
+    with _daemon_lock:
+        if _daemon is None or _daemon.tool_path != tool_path:
+            _daemon = SymbolObfuscationDaemon(tool_path)
+            atexit.register(_daemon.stop)
+        return _daemon
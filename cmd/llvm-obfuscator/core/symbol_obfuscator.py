@@ -13,18 +13,27 @@ from pathlib import Path
 from typing import Dict, Optional
 
 from .exceptions import ObfuscationError
+from .symbol_cache import ProjectSymbolCache
+from .symbol_daemon import SymbolDaemonError, get_symbol_daemon
 from .utils import create_logger, ensure_directory, require_tool
 
 logger = create_logger(__name__)
 
 
 class SymbolObfuscator:
-    """Symbol table cryptographic obfuscation using C++ tool."""
+    """Symbol table cryptographic obfuscation using C++ tool.
+
+    When the tool supports --daemon, requests go through one long-lived
+    process (see symbol_daemon) so its identifier->hash cache stays warm
+    across translation units; otherwise each call spawns the tool once,
+    exactly as before.
+    """
 
     TOOL_PATH = Path(__file__).parent.parent.parent.parent / "symbol-obfuscator" / "build" / "symbol-obfuscate"
 
-    def __init__(self):
+    def __init__(self, use_daemon: bool = True):
         self.logger = create_logger(__name__)
+        self._daemon = get_symbol_daemon(self.TOOL_PATH) if use_daemon else None
         self._check_tool()
 
     def _check_tool(self):
@@ -50,6 +59,7 @@ class SymbolObfuscator:
         generate_map: bool = True,
         map_file: Optional[Path] = None,
         is_cpp: bool = False,
+        project_cache: Optional[ProjectSymbolCache] = None,
     ) -> Dict:
         """
         Obfuscate symbols in source code.
@@ -66,6 +76,9 @@ class SymbolObfuscator:
             generate_map: Generate mapping file
             map_file: Path to mapping file
             is_cpp: Treat as C++ code
+            project_cache: Project-level symbol table; the per-TU map is
+                merged into it after obfuscation, and hashing parameters are
+                verified against it first so every TU renames consistently
 
         Returns:
             Dict with obfuscation results
@@ -81,6 +94,29 @@ class SymbolObfuscator:
 
         ensure_directory(output_file.parent)
 
+        # Fail fast on salt/parameter drift before renaming anything; a TU
+        # hashed with different parameters would not link against the rest
+        # of the project.
+        if project_cache is not None:
+            project_cache.verify_params(algorithm, hash_length, prefix_style, salt)
+
+        # Prefer the persistent daemon: one spawn per process instead of one
+        # per file, with the hash cache shared across TUs. Any daemon problem
+        # degrades to the one-shot path below.
+        if self._daemon is not None and self._daemon.available():
+            try:
+                result = self._obfuscate_via_daemon(
+                    source_file, output_file, algorithm, hash_length,
+                    prefix_style, salt, preserve_main, preserve_stdlib,
+                    generate_map, map_file, is_cpp,
+                )
+                self._merge_project_map(result, project_cache, generate_map)
+                return result
+            except SymbolDaemonError as exc:
+                self.logger.warning(
+                    f"Symbol daemon unavailable ({exc}); falling back to one-shot spawn"
+                )
+
         # Build command
         cmd = [
             str(self.TOOL_PATH),
@@ -132,7 +168,7 @@ class SymbolObfuscator:
                         map_data = json.load(f)
                         mappings = map_data.get("symbols", [])
 
-            return {
+            result = {
                 "success": True,
                 "symbols_obfuscated": len(mappings),
                 "mapping_file": str(map_file or (output_file.parent / "symbol_map.json")),
@@ -140,6 +176,8 @@ class SymbolObfuscator:
                 "algorithm": algorithm,
                 "hash_length": hash_length,
             }
+            self._merge_project_map(result, project_cache, generate_map)
+            return result
 
         except subprocess.TimeoutExpired:
             raise ObfuscationError("Symbol obfuscation timed out after 60 seconds")
@@ -151,6 +189,79 @@ class SymbolObfuscator:
         except Exception as e:
             raise ObfuscationError(f"Symbol obfuscation error: {str(e)}")
 
+    def _merge_project_map(
+        self,
+        result: Dict,
+        project_cache: Optional[ProjectSymbolCache],
+        generate_map: bool,
+    ) -> None:
+        """Fold this TU's map into the project table (no re-hashing) and
+        annotate the result with the project-wide totals."""
+        if project_cache is None or not generate_map:
+            return
+        added = project_cache.merge_map_file(Path(result["mapping_file"]))
+        stats = project_cache.stats()
+        result["project_map"] = stats["cache_file"]
+        result["project_new_symbols"] = added
+        result["project_total_symbols"] = stats["total_symbols"]
+
+    def _obfuscate_via_daemon(
+        self,
+        source_file: Path,
+        output_file: Path,
+        algorithm: str,
+        hash_length: int,
+        prefix_style: str,
+        salt: Optional[str],
+        preserve_main: bool,
+        preserve_stdlib: bool,
+        generate_map: bool,
+        map_file: Optional[Path],
+        is_cpp: bool,
+    ) -> Dict:
+        """Run one file through the persistent daemon (same results shape as
+        the one-shot path)."""
+        response = self._daemon.request({
+            "op": "obfuscate",
+            "input": str(source_file),
+            "output": str(output_file),
+            "options": {
+                "algorithm": algorithm,
+                "length": hash_length,
+                "prefix": prefix_style,
+                "salt": salt,
+                "preserve_main": preserve_main,
+                "preserve_stdlib": preserve_stdlib,
+                "generate_map": generate_map,
+                "map_file": str(map_file) if map_file else None,
+                "cpp": is_cpp,
+            },
+        })
+
+        if not response.get("ok"):
+            # A per-file failure is a real obfuscation error, not a daemon
+            # transport problem - do not retry it through the one-shot path.
+            error = response.get("error", "unknown daemon error")
+            self.logger.error(f"Symbol obfuscation failed: {error}")
+            raise ObfuscationError(f"Symbol obfuscation failed: {error}")
+
+        mappings = []
+        if generate_map:
+            map_path = map_file or (output_file.parent / "symbol_map.json")
+            if map_path.exists():
+                with open(map_path) as f:
+                    map_data = json.load(f)
+                    mappings = map_data.get("symbols", [])
+
+        return {
+            "success": True,
+            "symbols_obfuscated": response.get("symbols_obfuscated", len(mappings)),
+            "mapping_file": str(map_file or (output_file.parent / "symbol_map.json")),
+            "output_file": str(output_file),
+            "algorithm": algorithm,
+            "hash_length": hash_length,
+        }
+
     def analyze_symbols(self, binary: Path) -> Dict:
         """
         Analyze symbols in a binary.
@@ -0,0 +1,163 @@
+from __future__ import annotations
+
+import json
+import os
+import shutil
+import threading
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional
+
+from .utils import create_logger, ensure_directory
+
+DEFAULT_CACHE_FILE = Path(os.environ.get(
+    "LLVM_OBFUSCATOR_CACHE_DIR",
+    str(Path.home() / ".cache" / "llvm-obfuscator"),
+)) / "toolchain.json"
+
+
+def _fingerprint(path: Optional[str]) -> str:
+    """path:mtime:size for an existing file, 'missing' otherwise."""
+    if not path:
+        return "none"
+    try:
+        stat = Path(path).stat()
+        return f"{path}:{int(stat.st_mtime)}:{stat.st_size}"
+    except OSError:
+        return f"{path}:missing"
+
+
+class ToolchainResolver:
+    """Memoized toolchain probing shared by the CLI, API, and batch workers.
+
+    Plugin discovery, `clang -print-resource-dir`, and tool lookups cost a
+    subprocess spawn or a handful of stat calls per job; with a batch of
+    hundreds of TUs that is pure overhead, since the toolchain does not
+    change mid-run. Results are cached in memory and persisted to a small
+    JSON file so fresh processes start warm. Every hit is revalidated
+    against the fingerprint (mtime/size) of the binaries it depends on —
+    swap the plugin or upgrade clang and the entry re-probes, no manual
+    invalidation needed.
+    """
+
+    def __init__(self, cache_file: Path = DEFAULT_CACHE_FILE) -> None:
+        self.logger = create_logger(__name__)
+        self.cache_file = cache_file
+        self._lock = threading.Lock()
+        self._entries: Dict[str, Dict] = self._load()
+
+    def cached(
+        self,
+        key: str,
+        fingerprint_paths: List[Optional[str]],
+        probe: Callable[[], Any],
+    ) -> Any:
+        """Return the cached value for key, re-probing when fingerprints drift.
+
+        fingerprint_paths are the files whose mtime/size the value depends on
+        (compiler binary, plugin). The probed value must be JSON-serializable.
+        """
+        prints = [_fingerprint(path) for path in fingerprint_paths]
+        with self._lock:
+            entry = self._entries.get(key)
+            if entry and entry.get("fingerprints") == prints:
+                return entry["value"]
+        value = probe()
+        with self._lock:
+            self._entries[key] = {"value": value, "fingerprints": prints}
+            self._persist()
+        return value
+
+    def cached_path(self, key: str, probe: Callable[[], Optional[str]]) -> Optional[str]:
+        """Cache a probed file path, validated against its own fingerprint.
+
+        Used where the path is the probe's result (e.g. plugin discovery), so
+        it cannot be fingerprinted up front. A cached "not found" is treated
+        as a miss — re-probing for absence is just stat calls.
+        """
+        with self._lock:
+            entry = self._entries.get(key)
+            if entry and entry["value"] is not None:
+                if _fingerprint(entry["value"]) == entry.get("fingerprints", [None])[0]:
+                    return entry["value"]
+        value = probe()
+        with self._lock:
+            self._entries[key] = {"value": value, "fingerprints": [_fingerprint(value)]}
+            self._persist()
+        return value
+
+    def which(self, tool: str) -> Optional[str]:
+        """Cached shutil.which, revalidated against the resolved binary."""
+        with self._lock:
+            entry = self._entries.get(f"which:{tool}")
+            if entry and _fingerprint(entry["value"]) == entry.get("fingerprints", [None])[0]:
+                return entry["value"]
+        path = shutil.which(tool)
+        with self._lock:
+            self._entries[f"which:{tool}"] = {"value": path, "fingerprints": [_fingerprint(path)]}
+            self._persist()
+        return path
+
+    def require(self, tool: str, probe: Callable[[], None]) -> None:
+        """Run a require_tool-style probe once per toolchain state.
+
+        The probe raises if the tool is missing; a success is cached against
+        the resolved binary's fingerprint so subsequent jobs skip the check.
+        """
+        key = f"require:{tool}"
+        resolved = shutil.which(tool)
+        prints = [_fingerprint(resolved)]
+        with self._lock:
+            entry = self._entries.get(key)
+            if entry and entry.get("fingerprints") == prints and entry["value"]:
+                return
+        probe()  # raises on failure; nothing cached in that case
+        if resolved is None:
+            # Tool not on PATH but the probe passed (e.g. stubbed in tests);
+            # don't cache a success we can't fingerprint.
+            return
+        with self._lock:
+            self._entries[key] = {"value": True, "fingerprints": prints}
+            self._persist()
+
+    def descriptor(self) -> Dict:
+        """Snapshot of everything resolved so far, for diagnostics endpoints."""
+        with self._lock:
+            return {key: entry["value"] for key, entry in sorted(self._entries.items())}
+
+    def invalidate(self) -> None:
+        with self._lock:
+            self._entries = {}
+            self._persist()
+
+    # Internal --------------------------------------------------------------
+
+    def _load(self) -> Dict[str, Dict]:
+        try:
+            with self.cache_file.open("r", encoding="utf-8") as f:
+                data = json.load(f)
+            if isinstance(data, dict):
+                return data
+        except (OSError, json.JSONDecodeError):
+            pass
+        return {}
+
+    def _persist(self) -> None:
+        try:
+            ensure_directory(self.cache_file.parent)
+            with self.cache_file.open("w", encoding="utf-8") as f:
+                json.dump(self._entries, f, indent=2)
+        except OSError:  # pragma: no cover - cache is best-effort
+            self.logger.debug("Could not persist toolchain cache to %s", self.cache_file)
+
+
+_toolchain: Optional[ToolchainResolver] = None
+_toolchain_lock = threading.Lock()
+
+
+def get_toolchain() -> ToolchainResolver:
+    """Process-wide resolver so every LLVMObfuscator shares one cache."""
+    global _toolchain
+    with _toolchain_lock:
+        if _toolchain is None:
+            _toolchain = ToolchainResolver()
+        return _toolchain
@@ -200,6 +200,15 @@ def normalize_flags_and_passes(flags: Iterable[str]) -> Tuple[List[str], Dict[st
 def summarize_symbols(binary_path: Path) -> Tuple[int, int]:
     if not binary_path.exists():
         return 0, 0
+    # Native parser first: no nm spawn, no re-read through a pipe. The
+    # subprocess path below only runs for formats the parser rejects.
+    from .analyzer import BinaryParseError, analyze_cached
+
+    try:
+        metrics = analyze_cached(binary_path)
+        return metrics["symbols_count"], metrics["functions_count"]
+    except (BinaryParseError, OSError):
+        pass
     nm_tool = "llvm-nm" if tool_exists("llvm-nm") else "nm"
     try:
         _, stdout, _ = run_command([nm_tool, str(binary_path)])
@@ -225,6 +234,12 @@ def write_pdf_placeholder(path: Path) -> None:
 def list_sections(binary_path: Path) -> Dict[str, int]:
     if not binary_path.exists():
         return {}
+    from .analyzer import BinaryParseError, analyze_cached
+
+    try:
+        return analyze_cached(binary_path)["sections"]
+    except (BinaryParseError, OSError):
+        pass
     objdump = "llvm-objdump" if tool_exists("llvm-objdump") else "objdump"
     try:
         _, stdout, _ = run_command([objdump, "-h", str(binary_path)])
@@ -0,0 +1,127 @@
+"""
+Stateless obfuscation worker.
+
+Scale-out counterpart to the in-process JobExecutor: the API node enqueues
+self-contained job payloads to the shared JobQueue, and any number of worker
+processes on any number of machines pull them, run LLVMObfuscator locally
+with their own bundled toolchain, and push the artifacts into the shared
+report store. The worker heartbeats its lease through the obfuscator's
+progress callback, so a worker that dies mid-compile simply stops renewing
+and the queue hands the job to someone else.
+"""
+
+from __future__ import annotations
+
+import base64
+import os
+import socket
+import threading
+from pathlib import Path
+from typing import Dict, Optional
+
+from .config import ObfuscationConfig, Platform
+from .exceptions import JobNotFoundError
+from .job_manager import JobManager
+from .job_queue import JobQueue
+from .obfuscator import LLVMObfuscator
+from .report_store import ReportStore
+from .reporter import ObfuscationReport
+from .utils import create_logger, ensure_directory
+
+
+class ObfuscationWorker:
+    """Claim-execute-report loop over the shared job queue."""
+
+    def __init__(
+        self,
+        queue: JobQueue,
+        job_manager: JobManager,
+        report_store: Optional[ReportStore] = None,
+        work_root: Path = Path("./worker-jobs"),
+        worker_id: Optional[str] = None,
+        poll_interval: float = 2.0,
+    ) -> None:
+        self.logger = create_logger(__name__)
+        self.queue = queue
+        self.job_manager = job_manager
+        self.report_store = report_store
+        self.work_root = work_root
+        self.worker_id = worker_id or f"{socket.gethostname()}-{os.getpid()}"
+        self.poll_interval = poll_interval
+        self._stop = threading.Event()
+
+    def stop(self) -> None:
+        self._stop.set()
+
+    def run_forever(self) -> None:
+        self.logger.info("Worker %s polling for jobs", self.worker_id)
+        while not self._stop.is_set():
+            if not self.run_once():
+                self._stop.wait(self.poll_interval)
+        self.logger.info("Worker %s stopped", self.worker_id)
+
+    def run_once(self) -> bool:
+        """Claim and execute one job; returns False when the queue was empty."""
+        claimed = self.queue.claim(self.worker_id)
+        if not claimed:
+            return False
+        job_id, payload = claimed
+        self._execute(job_id, payload)
+        return True
+
+    # Internal --------------------------------------------------------------
+
+    def _execute(self, job_id: str, payload: Dict) -> None:
+        self.logger.info("Worker %s running job %s", self.worker_id, job_id)
+        working_dir = self.work_root / job_id
+        ensure_directory(working_dir)
+        try:
+            self._update_registry(job_id, status="running", worker=self.worker_id)
+            source_path = working_dir / payload["filename"]
+            source_path.write_bytes(base64.b64decode(payload["source_b64"]))
+
+            # Artifacts build in the worker's local scratch; the config dict
+            # from the API still points at the API node's report directory.
+            config_data = dict(payload["config"])
+            config_data.setdefault("output", {})["directory"] = str(working_dir)
+            config = ObfuscationConfig.from_dict(config_data)
+
+            obfuscator = LLVMObfuscator(
+                reporter=ObfuscationReport(working_dir),
+                # Each progress event renews the lease; a dead worker stops
+                # renewing and the queue requeues the job after one lease.
+                progress_callback=lambda event: self.queue.heartbeat(job_id, self.worker_id),
+            )
+            platforms = [Platform.from_string(p) for p in payload.get("platforms") or []]
+            if platforms:
+                result = obfuscator.obfuscate_multi(source_path, config, platforms, job_id=job_id)
+            else:
+                result = obfuscator.obfuscate(source_path, config, job_id=job_id)
+
+            self._update_registry(job_id, status="completed", result=result, worker=self.worker_id)
+            try:
+                self.job_manager.attach_reports(job_id, result.get("report_paths", {}))
+            except JobNotFoundError:
+                pass
+            if self.report_store:
+                try:
+                    stored = self.report_store.ingest_directory(job_id, working_dir)
+                    self.logger.info("Pushed %d artifacts for job %s", len(stored), job_id)
+                except Exception:  # pragma: no cover - push is best-effort
+                    self.logger.exception("Report store push failed for job %s", job_id)
+            self.queue.complete(job_id, self.worker_id)
+        except Exception as exc:
+            self.logger.exception("Job %s failed on worker %s", job_id, self.worker_id)
+            requeued = self.queue.fail(job_id, self.worker_id, str(exc))
+            self._update_registry(
+                job_id,
+                status="pending" if requeued else "failed",
+                error=str(exc),
+                worker=self.worker_id,
+            )
+
+    def _update_registry(self, job_id: str, status: str, **metadata) -> None:
+        try:
+            self.job_manager.update_job(job_id, status=status, **metadata)
+        except JobNotFoundError:  # registry purged the record; queue still rules
+            self.logger.warning("Job %s missing from registry", job_id)
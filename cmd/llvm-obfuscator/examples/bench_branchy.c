@@ -0,0 +1,28 @@
+/* Benchmark kernel: branch-heavy logic.
+ *
+ * Data-dependent branches over a pseudorandom stream; this is the shape of
+ * code that control-flow flattening and bogus control flow hurt the most.
+ * Prints a deterministic checksum so the harness can verify that an
+ * obfuscated build still computes the same result.
+ */
+#include <stdio.h>
+#include <stdint.h>
+
+int main(void) {
+    uint32_t state = 0x12345678u;
+    uint64_t checksum = 0;
+    for (int i = 0; i < 8000000; i++) {
+        state = state * 1664525u + 1013904223u;
+        if (state & 1u) {
+            checksum += state >> 3;
+        } else if (state & 2u) {
+            checksum ^= state;
+        } else if (state % 7u == 0u) {
+            checksum -= state >> 5;
+        } else {
+            checksum += 1;
+        }
+    }
+    printf("checksum=%llu\n", (unsigned long long)checksum);
+    return 0;
+}
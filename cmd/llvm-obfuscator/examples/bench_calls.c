@@ -0,0 +1,27 @@
+/* Benchmark kernel: call-heavy code.
+ *
+ * Deep recursion plus dispatch through a function-pointer table; prologue
+ * and epilogue bloat from the passes shows up here first. Prints a
+ * deterministic checksum.
+ */
+#include <stdio.h>
+#include <stdint.h>
+
+static uint64_t fib(uint32_t n) {
+    return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+static uint64_t op_add(uint64_t x) { return x + 7; }
+static uint64_t op_xor(uint64_t x) { return x ^ 0x5bd1e995u; }
+static uint64_t op_rot(uint64_t x) { return (x << 5) | (x >> 59); }
+static uint64_t op_mul(uint64_t x) { return x * 31; }
+
+int main(void) {
+    uint64_t (*ops[4])(uint64_t) = {op_add, op_xor, op_rot, op_mul};
+    uint64_t checksum = fib(27);
+    for (int i = 0; i < 12000000; i++) {
+        checksum = ops[i & 3](checksum);
+    }
+    printf("checksum=%llu\n", (unsigned long long)checksum);
+    return 0;
+}
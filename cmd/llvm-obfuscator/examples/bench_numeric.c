@@ -0,0 +1,37 @@
+/* Benchmark kernel: numeric loops.
+ *
+ * Dense integer matrix multiplication; arithmetic in tight loops is where
+ * instruction substitution and linear-MBA rewriting cost the most (the
+ * motivation for the MBA budget knobs). Prints a deterministic checksum.
+ */
+#include <stdio.h>
+#include <stdint.h>
+
+#define N 96
+#define ITERATIONS 100
+
+static int32_t a[N][N], b[N][N], c[N][N];
+
+int main(void) {
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            a[i][j] = (i * 31 + j * 17) & 0xFF;
+            b[i][j] = (i * 13 ^ j * 7) & 0xFF;
+        }
+    }
+    uint64_t checksum = 0;
+    for (int iter = 0; iter < ITERATIONS; iter++) {
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                int32_t sum = 0;
+                for (int k = 0; k < N; k++) {
+                    sum += a[i][k] * b[k][j];
+                }
+                c[i][j] = sum ^ (iter & 3);
+            }
+        }
+        checksum += (uint32_t)c[iter % N][(iter * 5) % N];
+    }
+    printf("checksum=%llu\n", (unsigned long long)checksum);
+    return 0;
+}
@@ -0,0 +1,29 @@
+/* Benchmark kernel: string handling.
+ *
+ * Repeated formatting, copying and scanning of small strings; measures what
+ * string encryption and the decryption helpers cost on code that touches
+ * literals constantly. Prints a deterministic checksum.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+int main(void) {
+    char buffer[128];
+    uint64_t checksum = 0;
+    for (int i = 0; i < 400000; i++) {
+        snprintf(buffer, sizeof(buffer), "record-%d:%s", i, (i & 1) ? "odd" : "even");
+        checksum += strlen(buffer);
+        if (strstr(buffer, "odd")) {
+            checksum += 3;
+        }
+        if (strncmp(buffer, "record-", 7) == 0) {
+            checksum += (uint8_t)buffer[7];
+        }
+        char copy[128];
+        strcpy(copy, buffer);
+        checksum += (uint8_t)copy[strlen(copy) - 1];
+    }
+    printf("checksum=%llu\n", (unsigned long long)checksum);
+    return 0;
+}
@@ -48,6 +48,35 @@ def test_cross_platform(sample_source, obfuscation_config, obfuscator: LLVMObfus
     assert result["output_file"].endswith(".exe")
 
 
+def test_analyze_falls_back_on_unparseable_binary(tmp_path):
+    """Native analyzer rejects malformed binaries and the legacy path answers"""
+    from core.analyzer import analyze_binary
+    from core.config import AnalyzeConfig
+
+    fake = tmp_path / "fake.bin"
+    fake.write_bytes(b"\x7fELFnotreallyanelf")
+    report = analyze_binary(AnalyzeConfig(binary_path=fake))
+    assert report["binary_format"] == "ELF"
+    assert report["file_size"] == fake.stat().st_size
+    assert {"sections", "symbols_count", "functions_count", "entropy"} <= set(report)
+
+
+def test_multi_platform_fanout(sample_source, obfuscation_config, obfuscator: LLVMObfuscator):
+    """Test one job fanning out to several platform targets"""
+    from core.config import Platform
+
+    result = obfuscator.obfuscate_multi(
+        sample_source, obfuscation_config, [Platform.LINUX, Platform.WINDOWS]
+    )
+    assert result["platforms_built"] == ["linux", "windows"]
+    urls = result["download_urls"]
+    for platform_name in ("linux", "windows"):
+        binary = Path(urls[platform_name]["path"])
+        assert binary.exists()
+        assert binary.parent.name == platform_name
+    assert urls["windows"]["path"].endswith(".exe")
+
+
 @pytest.mark.parametrize("endpoint", ["/api/jobs", "/api/health"])
 def test_api_endpoints_get(endpoint):
     """Test API GET endpoints with authentication"""
@@ -99,6 +128,215 @@ def test_api_endpoints_obfuscate_flow(sample_source, base64_source):
     assert report_response.status_code == 200
 
 
+def test_report_store_dedup_and_gc(tmp_path):
+    """Identical artifacts share one blob; expired jobs free their blobs"""
+    from core.report_store import ReportStore
+
+    store = ReportStore(tmp_path / "store", ttl_seconds=3600)
+    job_dir = tmp_path / "job"
+    job_dir.mkdir()
+    (job_dir / "report.json").write_text('{"ok": true}')
+    (job_dir / "source.c").write_text("int main(){return 0;}")
+
+    store.ingest_directory("job-a", job_dir)
+    store.ingest_directory("job-b", job_dir)
+    stats = store.stats()
+    assert stats["artifacts"] == 4
+    assert stats["blobs"] == 2  # identical content stored once
+    assert store.read("job-b", "report.json") == b'{"ok": true}'
+
+    store.ttl_seconds = 1
+    time.sleep(1.1)
+    assert store.purge_expired() == 4
+    assert store.stats()["blobs"] == 0
+    assert store.read("job-a", "report.json") is None
+
+
+def test_compare_section_diff(tmp_path):
+    """Identical inputs score full similarity, modified inputs do not"""
+    from core.comparer import compare_binaries
+    from core.config import CompareConfig
+
+    original = tmp_path / "a.bin"
+    original.write_bytes(b"\x01\x02\x03\x04" * 1024)
+    modified = tmp_path / "b.bin"
+    modified.write_bytes(b"\x01\x02\x03\x05" * 1024)
+
+    same = compare_binaries(CompareConfig(original_binary=original, obfuscated_binary=original))
+    assert same["overall_similarity"] == 1.0
+    changed = compare_binaries(CompareConfig(original_binary=original, obfuscated_binary=modified))
+    assert changed["overall_similarity"] < 1.0
+    assert changed["size_delta"] == 0
+    assert "symbol_overlap" in changed
+
+
+def test_profile_guided_adaptive_level(sample_source, tmp_path, monkeypatch):
+    """Adaptive level merges the hottest profiled functions into skip_functions"""
+    from core.config import (
+        ObfuscationConfig,
+        ObfuscationLevel,
+        OutputConfiguration,
+        PassConfiguration,
+        Platform,
+        ProfileGuidedConfiguration,
+    )
+    from core.profile_guide import ProfileGuidedPlanner
+
+    # Decision math: the hot function alone blows a 2% budget at the assumed
+    # 20% overhead factor, the cold ones fit.
+    decisions, excluded, predicted = ProfileGuidedPlanner._decide(
+        {"hot_loop": 9900, "warm": 90, "cold": 10}, budget_percent=2.0
+    )
+    assert excluded[0] == "hot_loop"
+    assert predicted <= 2.0
+    assert decisions["cold"]["decision"] == "obfuscate"
+
+    captured = {}
+
+    def fake_plan(self, source_file, config, output_directory):
+        captured["workload"] = config.profile_guided.workload
+        return {
+            "enabled": True,
+            "workload": config.profile_guided.workload,
+            "total_samples": 10000,
+            "overhead_budget_percent": 2.0,
+            "assumed_pass_overhead_percent": 20.0,
+            "predicted_overhead_percent": 0.2,
+            "excluded_functions": ["hot_loop"],
+            "functions": {},
+        }
+
+    monkeypatch.setattr(ProfileGuidedPlanner, "plan", fake_plan)
+    config = ObfuscationConfig(
+        level=ObfuscationLevel.ADAPTIVE,
+        platform=Platform.LINUX,
+        passes=PassConfiguration(flattening=True),
+        output=OutputConfiguration(directory=tmp_path / "out"),
+        profile_guided=ProfileGuidedConfiguration(workload="{binary}"),
+    )
+    result = LLVMObfuscator().obfuscate(sample_source, config)
+    assert captured["workload"] == "{binary}"
+    assert result["profile_guided"]["excluded_functions"] == ["hot_loop"]
+
+
+def test_streaming_eh_scan(tmp_path):
+    """EH detection streams the IR and names the affected functions"""
+    ir = tmp_path / "unit.ll"
+    ir.write_text(
+        "define i32 @clean(i32 %a) {\n"
+        "entry:\n  ret i32 %a\n}\n"
+        'define void @"_Z6throwyv"() {\n'
+        "entry:\n"
+        "  %c = invoke i32 @clean(i32 1)\n"
+        "          to label %cont unwind label %lpad\n"
+        "cont:\n  ret void\n"
+        "lpad:\n"
+        "  %lp = landingpad { ptr, i32 } cleanup\n"
+        "  resume { ptr, i32 } %lp\n"
+        "}\n"
+    )
+    obfuscator = LLVMObfuscator()
+    assert obfuscator._has_exception_handling(ir) is True
+    eh_functions, total = obfuscator._scan_exception_handling(ir)
+    assert total == 2
+    assert eh_functions == ["_Z6throwyv"]
+
+
+def test_fake_loop_decoys_injected(sample_source, tmp_path):
+    """Decoys carry opaque predicates and are appended to the working source"""
+    from core.config import (
+        AdvancedConfiguration,
+        ObfuscationConfig,
+        OutputConfiguration,
+    )
+    from core.fake_loop_inserter import FakeLoopGenerator
+
+    loops = FakeLoopGenerator().generate(3, "sample.c")
+    assert all(loop.predicate for loop in loops)
+    assert all("__obf_decoy_" in loop.code_snippet for loop in loops)
+
+    config = ObfuscationConfig(
+        advanced=AdvancedConfiguration(fake_loops=3),
+        output=OutputConfiguration(directory=tmp_path / "out"),
+    )
+    result = LLVMObfuscator().obfuscate(sample_source, config)
+    assert result["fake_loops_inserted"]["count"] == 3
+    assert len(result["fake_loops_inserted"]["predicates"]) == 3
+    decoy_sources = list((tmp_path / "out").glob("*_decoys.c"))
+    assert decoy_sources and "__obf_decoy_0" in decoy_sources[0].read_text()
+
+
+def test_benchmark_combinations_and_regression_compare():
+    """Combo enumeration is exhaustive; the baseline compare flags slowdowns"""
+    from core.benchmark import compare_baselines, pass_combinations
+
+    combos = pass_combinations()
+    assert len(combos) == 32  # 2^5 pass subsets
+    assert combos[0] == []  # baseline build comes first
+    assert len(pass_combinations(max_size=1)) == 6
+
+    baseline = {"results": [
+        {"kernel": "bench_numeric.c", "passes": "flattening", "runtime_ms": 100.0},
+        {"kernel": "bench_calls.c", "passes": "split", "runtime_ms": 50.0},
+    ]}
+    current = {"results": [
+        {"kernel": "bench_numeric.c", "passes": "flattening", "runtime_ms": 130.0},
+        {"kernel": "bench_calls.c", "passes": "split", "runtime_ms": 52.0},
+        {"kernel": "bench_calls.c", "passes": "none", "runtime_ms": 40.0},
+    ]}
+    report = compare_baselines(current, baseline, tolerance_percent=10.0)
+    assert report["compared"] == 2
+    assert [r["passes"] for r in report["regressions"]] == ["flattening"]
+    assert report["regressions"][0]["change_percent"] == 30.0
+    assert report["only_in_current"] == ["bench_calls.c::none"]
+
+
+def test_distributed_queue_and_worker(sample_source, tmp_path):
+    """Test the shared job queue and a stateless worker end to end"""
+    from core.job_manager import JobManager
+    from core.job_queue import JobQueue
+    from core.report_store import ReportStore
+    from core.worker import ObfuscationWorker
+
+    queue = JobQueue(db_path=tmp_path / "queue.db", lease_seconds=300, max_attempts=2)
+    registry = JobManager(db_path=tmp_path / "jobs.db")
+    store = ReportStore(tmp_path / "store")
+
+    payload = {
+        "filename": "sample.c",
+        "source_b64": base64.b64encode(sample_source.read_bytes()).decode("ascii"),
+        "config": {"level": 3, "output": {"directory": "/unused", "report_format": ["json"]}},
+        "platforms": [],
+    }
+    job = registry.create_job({"filename": "sample.c"})
+    queue.enqueue(job.job_id, payload)
+
+    worker = ObfuscationWorker(
+        queue, registry, store, work_root=tmp_path / "scratch", worker_id="worker-a"
+    )
+    assert worker.run_once() is True
+    assert worker.run_once() is False
+
+    record = registry.get_job(job.job_id)
+    assert record.status == "completed"
+    assert record.metadata.get("worker") == "worker-a"
+    assert store.artifact_names(job.job_id)
+    assert queue.stats() == {"pending": 0, "claimed": 0, "dead": 0}
+
+    # A claimed job whose worker stops heartbeating goes back to pending,
+    # and a job that exhausts its attempts is dead-lettered.
+    queue.enqueue("stuck-job", payload)
+    claimed = queue.claim("worker-b")
+    assert claimed is not None and claimed[0] == "stuck-job"
+    assert queue.heartbeat("stuck-job", "worker-b") is True
+    assert queue.heartbeat("stuck-job", "impostor") is False
+    assert queue.fail("stuck-job", "worker-b", "toolchain missing") is True
+    reclaimed = queue.claim("worker-c")
+    assert reclaimed is not None and reclaimed[0] == "stuck-job"
+    assert queue.fail("stuck-job", "worker-c", "toolchain missing") is False
+    assert queue.stats()["dead"] == 1
+
+
 def test_api_compare_endpoint(sample_source):
     """Test API compare endpoint"""
     data = sample_source.read_bytes()